@@ -0,0 +1,165 @@
+#include "Benchmark.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <utility>
+
+#include "../../../game/CollisionMask.hpp"
+
+Benchmark::Benchmark(BenchmarkOptions options)
+    : _options(std::move(options))
+{
+    loadMap();
+}
+
+void Benchmark::loadMap()
+{
+    nlohmann::json json;
+    {
+        std::ifstream file(_options.mapPath);
+        if (!file.is_open())
+            throw std::runtime_error("Cannot open file: " + _options.mapPath);
+        file >> json;
+    }
+
+    const auto width = json["width"].get<size_t>();
+    const auto height = json["height"].get<size_t>();
+    const auto cellSize = json["cellSize"].get<float>();
+    _area = {static_cast<float>(width) * cellSize, static_cast<float>(height) * cellSize};
+
+    std::vector solidTiles(height, std::vector(width, false));
+    for (const auto &tile : json["tiles"]) {
+        if (tile.contains("tags") || tile.value("isDestructible", false))
+            continue;
+        solidTiles[tile["y"].get<size_t>()][tile["x"].get<size_t>()] = true;
+    }
+
+    std::vector<sf::FloatRect> rects;
+    for (const auto &rect : core::ge::mergeCells(solidTiles)) {
+        rects.emplace_back(
+            static_cast<float>(rect.left) * cellSize, static_cast<float>(rect.top) * cellSize,
+            static_cast<float>(rect.width) * cellSize, static_cast<float>(rect.height) * cellSize);
+    }
+    const auto bvh = std::make_shared<const core::ge::StaticBVH>(std::move(rects));
+
+    auto &registry = _gameEngine.registry;
+    const core::ecs::Entity tiles = registry.spawn_entity();
+    registry.add_component(tiles, core::ge::TransformComponent{{0, 0}, _area, {1, 1}, 0});
+    registry.add_component(tiles, core::ge::CollisionComponent{TILE, {bvh->bounds()}, {}, bvh});
+}
+
+void Benchmark::spawnEntities()
+{
+    auto &registry = _gameEngine.registry;
+    std::uniform_real_distribution x(0.0f, _area.x);
+    std::uniform_real_distribution y(0.0f, _area.y);
+    std::uniform_real_distribution speed(-50.0f, 50.0f);
+    const auto count = [this](const core::ecs::Entity &, const core::ecs::Entity &) { ++_callbacks; };
+
+    for (size_t i = 0; i < _options.enemies; ++i) {
+        const core::ecs::Entity enemy = registry.spawn_entity();
+        registry.add_component(enemy, core::ge::TransformComponent{{x(_random), y(_random)}, {48, 48}, {1, 1}, 0});
+        registry.add_component(enemy, core::ge::VelocityComponent{-200.0f, speed(_random)});
+        registry.add_component(enemy, core::ge::CollisionComponent{ENEMY, {sf::FloatRect(0, 0, 48, 48)}, {
+            {PLAYER_PROJECTILE, count},
+            {TILE, count}}});
+        _entities.push_back(enemy);
+    }
+
+    for (size_t i = 0; i < _options.projectiles; ++i) {
+        const core::ecs::Entity projectile = registry.spawn_entity();
+        const sf::Vector2f position = {x(_random), y(_random)};
+        registry.add_component(projectile, core::ge::TransformComponent{position, {36, 10}, {1, 1}, 0});
+        registry.add_component(projectile, core::ge::VelocityComponent{500.0f, 0.0f});
+        registry.add_component(projectile, core::ge::ContinuousCollisionComponent{position, true});
+        registry.add_component(projectile, core::ge::CollisionComponent{PLAYER_PROJECTILE, {sf::FloatRect(0, 0, 36, 10)}, {
+            {ENEMY, count},
+            {TILE, count}}});
+        _entities.push_back(projectile);
+    }
+
+    for (size_t i = 0; i < _options.balls; ++i) {
+        const core::ecs::Entity ball = registry.spawn_entity();
+        registry.add_component(ball, core::ge::TransformComponent{{x(_random), y(_random)}, {24, 24}, {1, 1}, 0});
+        registry.add_component(ball, core::ge::VelocityComponent{speed(_random), speed(_random)});
+        registry.add_component(ball, core::ge::PhysicsComponent{1.0f, 0.8f, 0.0f});
+        registry.add_component(ball, core::ge::GravityComponent{});
+        registry.add_component(ball, core::ge::CollisionComponent{BALL, {sf::FloatRect(0, 0, 24, 24)}, {
+            {BALL, count},
+            {TILE, count}}});
+        _entities.push_back(ball);
+    }
+}
+
+void Benchmark::clearEntities()
+{
+    for (const auto &entity : _entities)
+        _gameEngine.registry.kill_entity(entity);
+    _entities.clear();
+}
+
+void Benchmark::wrapEntities()
+{
+    auto &registry = _gameEngine.registry;
+    for (const auto &entity : _entities) {
+        const auto &transform = registry.get_component<core::ge::TransformComponent>(entity);
+        const sf::Vector2f before = transform->position;
+
+        transform->position.x = std::fmod(std::fmod(transform->position.x, _area.x) + _area.x, _area.x);
+        transform->position.y = std::fmod(std::fmod(transform->position.y, _area.y) + _area.y, _area.y);
+
+        // A wrapped entity teleports: it must not be swept across the whole map.
+        if (transform->position != before && registry.has_component<core::ge::ContinuousCollisionComponent>(entity))
+            registry.get_component<core::ge::ContinuousCollisionComponent>(entity)->hasPreviousPosition = false;
+    }
+}
+
+BenchmarkResult Benchmark::run(const core::ge::Broadphase broadphase, const size_t threads)
+{
+    using Clock = std::chrono::steady_clock;
+
+    _random.seed(_options.seed);
+    _callbacks = 0;
+    _gameEngine.collisionDetector = core::ge::CollisionDetector{};
+    _gameEngine.collisionDetector.setBroadphase(broadphase);
+    _gameEngine.collisionDetector.setThreads(threads);
+    _gameEngine.delta_t = _options.deltaTime;
+    spawnEntities();
+
+    auto &registry = _gameEngine.registry;
+    BenchmarkResult result = {broadphase == core::ge::Broadphase::BruteForce ? "brute force" : "sweep and prune", threads, 0, 0, 0, 0, 0, 0};
+    Clock::duration total{};
+    Clock::duration collision{};
+
+    for (size_t tick = 0; tick < _options.ticks; ++tick) {
+        const auto start = Clock::now();
+        registry.run_system<core::ge::VelocityComponent, core::ge::PhysicsComponent, core::ge::GravityComponent>();
+        registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent, core::ge::PhysicsComponent>();
+        registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent>();
+        wrapEntities();
+
+        const auto collisionStart = Clock::now();
+        registry.run_system<core::ge::TransformComponent, core::ge::CollisionComponent>();
+        const auto end = Clock::now();
+
+        total += end - start;
+        collision += end - collisionStart;
+
+        const auto &stats = _gameEngine.collisionDetector.stats();
+        result.pairsTested += static_cast<double>(stats.pairsTested);
+        result.candidates += static_cast<double>(stats.candidates);
+        result.contacts += static_cast<double>(stats.contacts);
+    }
+    clearEntities();
+
+    const auto ticks = static_cast<double>(_options.ticks);
+    result.nsPerTick = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(total).count()) / ticks;
+    result.collisionNsPerTick = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(collision).count()) / ticks;
+    result.pairsTested /= ticks;
+    result.candidates /= ticks;
+    result.contacts /= ticks;
+    result.callbacks = static_cast<double>(_callbacks) / ticks;
+    return result;
+}
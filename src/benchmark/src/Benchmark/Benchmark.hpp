@@ -0,0 +1,68 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../../core/ecs/GameEngine/GameEngine.hpp"
+
+/**
+ * @struct BenchmarkOptions
+ * @brief Describes the scenario simulated by the benchmark.
+ */
+struct BenchmarkOptions {
+    std::string mapPath = "assets/JY_map.json"; ///< Map whose static tiles are loaded.
+    size_t ticks = 1000;                        ///< Number of ticks simulated per run.
+    float deltaTime = 1.0f / 60.0f;             ///< Fixed delta time of a tick, in seconds.
+    size_t enemies = 100;                       ///< Enemies spawned.
+    size_t projectiles = 300;                   ///< Fast projectiles spawned, swept by the collision system.
+    size_t balls = 50;                          ///< Balls spawned, driven by the physics system.
+    size_t threads = 4;                         ///< Narrowphase threads of the multi-threaded run.
+    unsigned seed = 42;                         ///< Seed of the spawn positions, shared by every run.
+};
+
+/**
+ * @struct BenchmarkResult
+ * @brief Measurements of one run, averaged per tick.
+ */
+struct BenchmarkResult {
+    std::string backend;
+    size_t threads;
+    double nsPerTick;
+    double collisionNsPerTick;
+    double pairsTested;
+    double candidates;
+    double contacts;
+    double callbacks;
+};
+
+/**
+ * @class Benchmark
+ * @brief Runs the collision, velocity and physics systems headlessly on a fixed scenario.
+ *
+ * Every run respawns the same entities from the same seed, so backends are compared on identical work.
+ */
+class Benchmark {
+public:
+    explicit Benchmark(BenchmarkOptions options);
+
+    BenchmarkResult run(core::ge::Broadphase broadphase, size_t threads);
+
+private:
+    void loadMap();
+    void spawnEntities();
+    void clearEntities();
+    void wrapEntities();
+
+    BenchmarkOptions _options;
+    std::ostream _log{nullptr};            ///< Discards the engine log, which also keeps the engine from starting its shell.
+    core::GameEngine _gameEngine{false, &_log};
+    std::mt19937 _random;
+    sf::Vector2f _area;
+    std::vector<core::ecs::Entity> _entities;
+    size_t _callbacks = 0;
+};
+
+#endif //BENCHMARK_HPP
@@ -0,0 +1,119 @@
+#include "NetworkBenchmark.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static constexpr uint8_t DATA_MESSAGE = 0;
+static constexpr uint8_t END_MESSAGE = 1;
+static constexpr std::chrono::seconds STALL_TIMEOUT{1};
+
+// CPU time of the calling thread, in nanoseconds; only measured on POSIX systems
+static int64_t threadCpuTime()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+NetworkBenchmark::NetworkBenchmark(NetworkBenchmarkOptions options)
+    : _options(std::move(options))
+{
+}
+
+NetworkBenchmarkResult NetworkBenchmark::run(const NetworkingService::Transport transport, const bool batchedIo)
+{
+    using Clock = std::chrono::steady_clock;
+
+    NetworkingService receiver(0);
+    receiver.setTransport(transport);
+    receiver.setBatchedIo(batchedIo);
+    NetworkingService sender(0);
+    sender.setTransport(transport);
+    sender.setBatchedIo(batchedIo);
+
+    // The receive CPU time is taken on the network thread, from the first datagram to the end marker
+    std::atomic<size_t> received = 0;
+    std::atomic<bool> ended = false;
+    int64_t receiveCpuStart = 0;
+    int64_t receiveCpuEnd = 0;
+    receiver.addEvent(DATA_MESSAGE, [&](const GDTPHeader &, const std::span<const uint8_t>, const asio::ip::udp::endpoint &) {
+        if (received.load(std::memory_order_relaxed) == 0)
+            receiveCpuStart = threadCpuTime();
+        received.fetch_add(1, std::memory_order_release);
+    });
+    receiver.addEvent(END_MESSAGE, [&](const GDTPHeader &, const std::span<const uint8_t>, const asio::ip::udp::endpoint &) {
+        if (ended.load(std::memory_order_relaxed))
+            return;
+        receiveCpuEnd = threadCpuTime();
+        ended.store(true, std::memory_order_release);
+    });
+    receiver.run();
+    sender.init();
+
+    const auto endpoint = NetworkingService::resolve("127.0.0.1", static_cast<int>(receiver.getPort()));
+    const std::vector<OutboundPacket> batch(NetworkingService::IO_BATCH_SIZE,
+        {endpoint, std::nullopt, DATA_MESSAGE, std::vector<uint8_t>(_options.payload, 0xAB)});
+
+    // Datagrams are sent a batch at a time, while fewer than a window of them are in flight
+    const auto start = Clock::now();
+    int64_t sendCpu = 0;
+    size_t sent = 0;
+    auto progress = Clock::now();
+    size_t lastReceived = 0;
+    while (sent < _options.packets) {
+        const size_t inFlight = sent - received.load(std::memory_order_acquire);
+        if (inFlight + batch.size() > std::max(_options.window, batch.size())) {
+            const size_t current = received.load(std::memory_order_acquire);
+            if (current != lastReceived) {
+                lastReceived = current;
+                progress = Clock::now();
+            } else if (Clock::now() - progress > STALL_TIMEOUT) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        const size_t count = std::min(batch.size(), _options.packets - sent);
+        const int64_t sendCpuStart = threadCpuTime();
+        sender.sendPackets(std::span(batch).first(count));
+        sendCpu += threadCpuTime() - sendCpuStart;
+        sent += count;
+    }
+
+    progress = Clock::now();
+    while (received.load(std::memory_order_acquire) < sent && Clock::now() - progress < STALL_TIMEOUT)
+        std::this_thread::yield();
+    const auto end = Clock::now();
+
+    // The end marker is sent again in case it is dropped
+    const std::vector<OutboundPacket> marker{{endpoint, std::nullopt, END_MESSAGE, {}}};
+    for (int attempt = 0; attempt < 10 && !ended.load(std::memory_order_acquire); ++attempt) {
+        sender.sendPackets(marker);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    const auto transportInUse = receiver.getTransport();
+    receiver.stop();
+    sender.stop();
+
+    const size_t count = received.load(std::memory_order_acquire);
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    NetworkBenchmarkResult result = {
+        transportInUse == NetworkingService::Transport::IoUring ? "io_uring" : batchedIo ? "asio batched" : "asio",
+        count, 0, 0, 0};
+    if (count == 0)
+        return result;
+    result.packetsPerSecond = static_cast<double>(count) / seconds;
+    result.receiveCpuNsPerPacket = ended ? static_cast<double>(receiveCpuEnd - receiveCpuStart) / static_cast<double>(count) : 0;
+    result.sendCpuNsPerPacket = static_cast<double>(sendCpu) / static_cast<double>(sent);
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef NETWORK_BENCHMARK_HPP
+#define NETWORK_BENCHMARK_HPP
+
+#include <string>
+
+#include "../../../core/network/NetworkService.hpp"
+
+/**
+ * @struct NetworkBenchmarkOptions
+ * @brief Describes the traffic sent over loopback by the network benchmark.
+ */
+struct NetworkBenchmarkOptions {
+    size_t packets = 0;   ///< Datagrams sent per run, the network benchmark only runs if set.
+    size_t payload = 64;  ///< Payload size of each datagram, in bytes.
+    size_t window = 128;  ///< Datagrams in flight at most, so that the socket buffer never overflows.
+};
+
+/**
+ * @struct NetworkBenchmarkResult
+ * @brief Measurements of one run.
+ */
+struct NetworkBenchmarkResult {
+    std::string transport;
+    size_t received;
+    double packetsPerSecond;
+    double receiveCpuNsPerPacket;
+    double sendCpuNsPerPacket;
+};
+
+/**
+ * @class NetworkBenchmark
+ * @brief Measures the throughput of a NetworkingService transport over loopback.
+ *
+ * A sender service floods a receiver service with datagrams through `sendPackets()`, the way the server's
+ * send queue does. The CPU time of the receiving network thread and of the sending thread are measured
+ * separately, so that the cost per packet of each side can be compared between transports.
+ */
+class NetworkBenchmark {
+public:
+    explicit NetworkBenchmark(NetworkBenchmarkOptions options);
+
+    NetworkBenchmarkResult run(NetworkingService::Transport transport, bool batchedIo);
+
+private:
+    NetworkBenchmarkOptions _options;
+};
+
+#endif //NETWORK_BENCHMARK_HPP
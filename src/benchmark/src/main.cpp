@@ -0,0 +1,114 @@
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Benchmark/Benchmark.hpp"
+#include "Benchmark/NetworkBenchmark.hpp"
+
+static void usage()
+{
+    std::cout << "Usage: r-type_benchmark [--map=PATH] [--ticks=N] [--enemies=N] [--projectiles=N] [--balls=N] [--threads=N] [--seed=N]" << std::endl;
+    std::cout << "       r-type_benchmark --packets=N [--payload=N]" << std::endl;
+}
+
+/**
+ * @brief Parses the whole value as an unsigned number, false if it is not one or does not fit.
+ */
+template<typename T>
+static bool parseNumber(const std::string &value, T &number)
+{
+    const char *end = value.data() + value.size();
+    const auto [ptr, ec] = std::from_chars(value.data(), end, number);
+    return ec == std::errc() && ptr == end;
+}
+
+static bool parseOption(const std::string &arg, BenchmarkOptions &options, NetworkBenchmarkOptions &networkOptions)
+{
+    const auto equal = arg.find('=');
+    if (equal == std::string::npos)
+        return false;
+    const std::string name = arg.substr(0, equal);
+    const std::string value = arg.substr(equal + 1);
+
+    if (name == "--map") {
+        options.mapPath = value;
+        return true;
+    }
+    // Results are averaged per tick
+    if (name == "--ticks")
+        return parseNumber(value, options.ticks) && options.ticks > 0;
+    if (name == "--enemies")
+        return parseNumber(value, options.enemies);
+    if (name == "--projectiles")
+        return parseNumber(value, options.projectiles);
+    if (name == "--balls")
+        return parseNumber(value, options.balls);
+    if (name == "--threads")
+        return parseNumber(value, options.threads);
+    if (name == "--seed")
+        return parseNumber(value, options.seed);
+    if (name == "--packets")
+        return parseNumber(value, networkOptions.packets);
+    if (name == "--payload")
+        return parseNumber(value, networkOptions.payload);
+    return false;
+}
+
+static int runNetworkBenchmark(const NetworkBenchmarkOptions &options)
+{
+    NetworkBenchmark benchmark(options);
+    std::vector<NetworkBenchmarkResult> results;
+    results.push_back(benchmark.run(NetworkingService::Transport::Asio, false));
+    results.push_back(benchmark.run(NetworkingService::Transport::Asio, true));
+    results.push_back(benchmark.run(NetworkingService::Transport::IoUring, true));
+
+    std::cout << options.packets << " packets of " << options.payload << " bytes over loopback" << std::endl;
+    std::cout << std::left << std::setw(15) << "transport" << std::right
+              << std::setw(11) << "received" << std::setw(15) << "packets/s"
+              << std::setw(16) << "recv cpu ns" << std::setw(16) << "send cpu ns" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto &result : results) {
+        std::cout << std::left << std::setw(15) << result.transport << std::right
+                  << std::setw(11) << result.received << std::setw(15) << result.packetsPerSecond
+                  << std::setw(16) << result.receiveCpuNsPerPacket << std::setw(16) << result.sendCpuNsPerPacket << std::endl;
+    }
+    return 0;
+}
+
+int main(const int argc, char **argv)
+{
+    BenchmarkOptions options;
+    NetworkBenchmarkOptions networkOptions;
+    for (int i = 1; i < argc; ++i) {
+        if (!parseOption(argv[i], options, networkOptions)) {
+            usage();
+            return 1;
+        }
+    }
+    if (networkOptions.packets > 0)
+        return runNetworkBenchmark(networkOptions);
+
+    Benchmark benchmark(options);
+    std::vector<BenchmarkResult> results;
+    results.push_back(benchmark.run(core::ge::Broadphase::BruteForce, 1));
+    results.push_back(benchmark.run(core::ge::Broadphase::SweepAndPrune, 1));
+    if (options.threads > 1)
+        results.push_back(benchmark.run(core::ge::Broadphase::SweepAndPrune, options.threads));
+
+    std::cout << options.ticks << " ticks, " << options.enemies << " enemies, " << options.projectiles << " projectiles, "
+              << options.balls << " balls on " << options.mapPath << std::endl;
+    std::cout << std::left << std::setw(18) << "broadphase" << std::right
+              << std::setw(9) << "threads" << std::setw(14) << "ns/tick" << std::setw(18) << "collision ns"
+              << std::setw(15) << "pairs tested" << std::setw(13) << "candidates" << std::setw(11) << "contacts"
+              << std::setw(12) << "callbacks" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto &result : results) {
+        std::cout << std::left << std::setw(18) << result.backend << std::right
+                  << std::setw(9) << result.threads << std::setw(14) << result.nsPerTick << std::setw(18) << result.collisionNsPerTick
+                  << std::setw(15) << result.pairsTested << std::setw(13) << result.candidates << std::setw(11) << result.contacts
+                  << std::setw(12) << result.callbacks << std::endl;
+    }
+    return 0;
+}
@@ -262,7 +262,7 @@ core::ecs::Entity EntityFactory::createPlayerMissile(Game &game, const sf::Vecto
     return missile;
 }
 
-core::ecs::Entity EntityFactory::createEnemy(Game &game, const sf::Vector2f& position, std::uint8_t enemyId)
+core::ecs::Entity EntityFactory::createEnemy(Game &game, const sf::Vector2f& position, std::uint16_t enemyId)
 {
     auto& gameEngine = game.getGameEngine();
     auto& registry = gameEngine.registry;
@@ -332,7 +332,7 @@ core::ecs::Entity EntityFactory::createEnemy(Game &game, const sf::Vector2f& pos
     return enemy;
 }
 
-core::ecs::Entity EntityFactory::createShooterEnemy(Game &game, const sf::Vector2f& position, std::uint8_t enemyId)
+core::ecs::Entity EntityFactory::createShooterEnemy(Game &game, const sf::Vector2f& position, std::uint16_t enemyId)
 {
     auto& gameEngine = game.getGameEngine();
     auto& registry = gameEngine.registry;
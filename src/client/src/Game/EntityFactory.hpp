@@ -57,7 +57,7 @@ public:
      * @param position The initial position of the enemy.
      * @return The created enemy entity.
      */
-    static core::ecs::Entity createEnemy(Game &game, const sf::Vector2f& position, std::uint8_t enemyId);
+    static core::ecs::Entity createEnemy(Game &game, const sf::Vector2f& position, std::uint16_t enemyId);
 
     /**
      * @brief Creates a shooter enemy entity with the given position and ID.
@@ -71,7 +71,7 @@ public:
      * @param enemyId A unique identifier for the shooter enemy.
      * @return The created shooter enemy entity.
      */
-    static core::ecs::Entity createShooterEnemy(Game &game, const sf::Vector2f& position, std::uint8_t enemyId);
+    static core::ecs::Entity createShooterEnemy(Game &game, const sf::Vector2f& position, std::uint16_t enemyId);
 
     /**
      * @brief Creates a ball entity that can interact with other game objects.
@@ -12,6 +12,7 @@
 #include "Systems.hpp"
 #include "src/event/EventPool.hpp"
 #include "src/Game/Utils/ClientComponents.hpp"
+#include "../../../game/Channels.hpp"
 #include "../../../game/Components.hpp"
 
 
@@ -105,6 +106,7 @@ void Game::init()
     _gameEngine.registry.register_component<EventComponent>();
     _gameEngine.registry.register_component<TileComponent>();
     _gameEngine.registry.register_component<HitAnimationComponent>();
+    _gameEngine.registry.register_component<InterpolationComponent>();
 
     loadingProgress(50);
     Systems::playerInput(*this);
@@ -112,6 +114,7 @@ void Game::init()
     Systems::gameView(*this);
     Systems::gameEvent(*this);
     Systems::hitAnimation(*this);
+    Systems::interpolation(*this);
 
     loadingProgress(60);
     _viewEntity = _gameEngine.registry.spawn_entity();
@@ -120,9 +123,18 @@ void Game::init()
     loadingProgress(70);
     _networkingService.init();
     setHandlers();
+    channels::configure(_networkingService);
 
     loadingProgress(80);
     _configManager.parse("assets/Data/config.json");
+    try {
+        _serverEndpoint = NetworkingService::resolve(
+            _configManager.getValue<std::string>("/network/ip", "127.0.0.1"),
+            _configManager.getValue<int>("/network/port", 1111));
+    } catch (const std::exception &e) {
+        std::cerr << "Invalid server address, using the local one: " << e.what() << std::endl;
+        _serverEndpoint = NetworkingService::resolve("127.0.0.1", 1111);
+    }
 
     loadingProgress(100);
     setGameState(GameState::MainMenu);
@@ -341,6 +353,7 @@ void Game::run() {
         _gameEngine.delta_t = elapsed.asSeconds();
 
         processEvents();
+        _networkingService.update();
         switch (_gameEngine.currentScene) {
             case MainMenu:
                 Scenes::updateMainMenu(*this);
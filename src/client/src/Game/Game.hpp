@@ -2,7 +2,7 @@
 
 #include <SFML/System/Clock.hpp>
 #include <list>
-#include <queue>
+#include <map>
 #include <SFML/System/Vector2.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include "../../../core/ecs/Entity/Entity.hpp"
@@ -10,6 +10,8 @@
 #include "../../../core/network/NetworkService.hpp"
 #include "../../../core/config/ConfigManager.hpp"
 #include "../../../game/Components.hpp"
+#include "Prediction.hpp"
+#include "SnapshotReceiver.hpp"
 
 /**
  * @struct Tile
@@ -52,18 +54,18 @@ public:
     bool metricsEnabled = false; ///< Flag to trac if the metrics are enabled.
     sf::Clock time; ///< Clock to track time elapsed in a game.
 
-    std::shared_ptr<std::queue<core::ecs::Entity>> _selfProjectileQueue = std::make_shared<std::queue<core::ecs::Entity>>(); ///< Queue of self projectiles.
-    std::shared_ptr<std::queue<core::ecs::Entity>> _selfMissileQueue = std::make_shared<std::queue<core::ecs::Entity>>(); ///< Queue of self missiles.
-
 private:
     GameState _gameState = GameState::Loading; ///< The current state of the game.
     core::GameEngine _gameEngine; ///< Game engine responsible for managing entities, components, and systems.
     std::list<core::ecs::Entity> _sceneEntities; ///< List of entities in the current scene.
     NetworkingService &_networkingService = NetworkingService::getInstance(); ///< Singleton instance of the networking service.
     ConfigManager _configManager;
+    asio::ip::udp::endpoint _serverEndpoint; ///< Address of the server, resolved once from the configuration.
     core::ecs::Entity _viewEntity; ///< The entity representing the game view.
 
     GDTPHeader _playerConnectionHeader{}; ///< Header for player connection requests.
+    SnapshotReceiver _snapshotReceiver; ///< Rebuilds the world snapshots replicated by the server.
+    Prediction _prediction; ///< Predicts the local player and what it spawns until the server confirms them.
 
     /**
      * @brief Processes SFML events like keyboard inputs, window resizing, and window closing.
@@ -149,11 +151,12 @@ public:
     core::ecs::Registry &getRegistry() { return _gameEngine.registry; }
     NetworkingService &getNetworkingService() { return _networkingService; }
     ConfigManager &getConfigManager() { return _configManager; }
+    const asio::ip::udp::endpoint &getServerEndpoint() const { return _serverEndpoint; }
     GameState getGameState() const { return _gameState; }
     sf::Vector2f getGameScale() const { return gameScale; }
     GDTPHeader &getPlayerConnectionHeader() { return _playerConnectionHeader; }
-    std::shared_ptr<std::queue<core::ecs::Entity>> getSelfProjectileQueue() const { return _selfProjectileQueue; }
-    std::shared_ptr<std::queue<core::ecs::Entity>> getSelfMissileQueue() const { return _selfMissileQueue; }
+    SnapshotReceiver &getSnapshotReceiver() { return _snapshotReceiver; }
+    Prediction &getPrediction() { return _prediction; }
 
     void setGameState(const GameState state) { _gameState = state; }
     void setPlayerConnectionHeader(const GDTPHeader &header) { _playerConnectionHeader = header; }
@@ -147,6 +147,12 @@ void Game::parseMap(Game &game, const std::string& mapFilePath, sf::RenderWindow
 
     initBackground(gameEngine.registry, mapData, window, gameScale);
 
+    std::vector solidTiles(mapData["height"].get<size_t>(), std::vector(mapData["width"].get<size_t>(), false));
+    const auto hidePlayer = [&](const core::ecs::Entity, const core::ecs::Entity other) {
+        auto drawable = gameEngine.registry.get_component<core::ge::DrawableComponent>(other);
+        drawable->visible = false;
+    };
+
     for (const auto& tile : mapData["tiles"]) {
         if (!tile.contains("tileIndex") || !tile.contains("x") || !tile.contains("y") || !tile.contains("isDestructible")) {
             std::cerr << "Warning: Tile data missing essential fields. Skipping tile." << std::endl;
@@ -171,6 +177,12 @@ void Game::parseMap(Game &game, const std::string& mapFilePath, sf::RenderWindow
             registry.add_component(tileEntity, core::ge::TextureComponent{tileTextures[tileIdx]});
             registry.add_component(tileEntity, TileComponent{isDestructible, tilePos});
 
+            _tileMap[tile["y"]][tile["x"]] = Tile{tileEntity, tilePos, isDestructible};
+            if (!isDestructible) {
+                solidTiles[tile["y"]][tile["x"]] = true;
+                continue;
+            }
+
             gameEngine.registry.add_component(tileEntity, core::ge::CollisionComponent{
                 WORLD, {sf::FloatRect(0.0f, 0.0f, mapData["cellSize"].get<float>() * gameScale.x, mapData["cellSize"].get<float>() * gameScale.y)},
                 {
@@ -205,19 +217,27 @@ void Game::parseMap(Game &game, const std::string& mapFilePath, sf::RenderWindow
                         //    std::cerr << "Error: HealthComponent not found for entity." << std::endl;
                         //}
                     }},
-                    {PLAYER, [&](const core::ecs::Entity, const core::ecs::Entity other) {
-                        auto drawable = gameEngine.registry.get_component<core::ge::DrawableComponent>(other);
-                        drawable->visible = false;
-                    }},
+                    {PLAYER, hidePlayer},
                 }
             });
-
-            _tileMap[tile["y"]][tile["x"]] = Tile{tileEntity, tilePos, isDestructible};
         } catch (const std::exception& e) {
             std::cerr << "Error: Exception while parsing tile data: " << e.what() << std::endl;
             continue;
         }
     }
 
+    const sf::Vector2f tileSize = mapData["cellSize"].get<float>() * gameScale;
+    std::vector<sf::FloatRect> staticRects;
+    for (const auto& rect : core::ge::mergeCells(solidTiles)) {
+        staticRects.emplace_back(
+            static_cast<float>(rect.left) * tileSize.x, static_cast<float>(rect.top) * tileSize.y,
+            static_cast<float>(rect.width) * tileSize.x, static_cast<float>(rect.height) * tileSize.y);
+    }
+    const auto staticTiles = std::make_shared<const core::ge::StaticBVH>(std::move(staticRects));
+    const core::ecs::Entity staticTilesEntity = registry.spawn_entity();
+    registry.add_component(staticTilesEntity, core::ge::TransformComponent{{0.0f, 0.0f}, {staticTiles->bounds().width, staticTiles->bounds().height}, {1.0f, 1.0f}, 0.0f});
+    registry.add_component(staticTilesEntity, core::ge::CollisionComponent{WORLD, {staticTiles->bounds()}, {{PLAYER, hidePlayer}}, staticTiles});
+    std::cout << "Static tiles merged into " << staticTiles->rects().size() << " colliders." << std::endl;
+
     std::cout << "Map parsed successfully." << std::endl;
 }
@@ -0,0 +1,105 @@
+#include "Prediction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+
+#include "../../../game/Movement.hpp"
+
+void Prediction::accumulate(const sf::Vector2f velocity, const float deltaTime)
+{
+    _unsent += velocity * deltaTime;
+}
+
+bool Prediction::inputDue(const float deltaTime, const float interval)
+{
+    _inputTimer += deltaTime;
+    if (_inputTimer < interval)
+        return false;
+    _inputTimer = std::fmod(_inputTimer, interval);
+    return true;
+}
+
+std::uint32_t Prediction::recordInput(const std::uint8_t input)
+{
+    _unsent = {};
+    const std::uint32_t sequence = ++_sequence;
+    _inputs[sequence % INPUT_BUFFER_SIZE] = {sequence, input};
+    return sequence;
+}
+
+sf::Vector2f Prediction::reconcile(const std::uint32_t ackedSequence, const sf::Vector2f authoritative, const sf::Vector2f speed, const float interval)
+{
+    // Acknowledgements of inputs never sent are ignored
+    if (movement::isNewer(ackedSequence, _ackedSequence) && !movement::isNewer(ackedSequence, _sequence))
+        _ackedSequence = ackedSequence;
+
+    // Inputs overwritten in the ring buffer were sent too long ago to still be on their way
+    const std::uint32_t pending = std::min<std::uint32_t>(_sequence - _ackedSequence, INPUT_BUFFER_SIZE);
+    sf::Vector2f predicted = authoritative + _unsent;
+    for (std::uint32_t sequence = _sequence - pending + 1; sequence != _sequence + 1; ++sequence) {
+        const PendingInput &input = _inputs[sequence % INPUT_BUFFER_SIZE];
+        if (input.sequence == sequence)
+            predicted += movement::velocity(input.input, speed) * interval;
+    }
+    return predicted;
+}
+
+sf::Vector2f Prediction::correct(const sf::Vector2f displayed, const sf::Vector2f predicted)
+{
+    _correction = predicted - displayed;
+    if (std::hypot(_correction.x, _correction.y) < SNAP_DISTANCE)
+        return {};
+
+    const sf::Vector2f correction = _correction;
+    _correction = {};
+    return correction;
+}
+
+sf::Vector2f Prediction::smooth(const float deltaTime)
+{
+    const sf::Vector2f step = _correction * std::min(deltaTime * CORRECTION_RATE, 1.0f);
+    _correction -= step;
+    return step;
+}
+
+void Prediction::predictSpawn(const ReplicatedKind kind, const core::ecs::Entity entity)
+{
+    _spawns[kind].push_back({entity, std::chrono::steady_clock::now()});
+}
+
+std::optional<core::ecs::Entity> Prediction::confirmSpawn(const ReplicatedKind kind)
+{
+    auto &spawns = _spawns[kind];
+    if (spawns.empty())
+        return std::nullopt;
+
+    const core::ecs::Entity entity = spawns.front().entity;
+    spawns.pop_front();
+    return entity;
+}
+
+std::vector<core::ecs::Entity> Prediction::expireSpawns()
+{
+    const auto expiry = std::chrono::steady_clock::now() - SPAWN_TIMEOUT;
+    std::vector<core::ecs::Entity> expired;
+
+    for (auto &spawns : _spawns | std::views::values) {
+        while (!spawns.empty() && spawns.front().time < expiry) {
+            expired.push_back(spawns.front().entity);
+            spawns.pop_front();
+        }
+    }
+    return expired;
+}
+
+void Prediction::clear()
+{
+    _inputs = {};
+    _sequence = 0;
+    _ackedSequence = 0;
+    _unsent = {};
+    _inputTimer = 0.0f;
+    _correction = {};
+    _spawns.clear();
+}
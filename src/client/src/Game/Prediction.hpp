@@ -0,0 +1,115 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "../../../core/ecs/Entity/Entity.hpp"
+#include "../../../game/Snapshot.hpp"
+
+/**
+ * @class Prediction
+ * @brief Predicts what the local player does before the server confirms it.
+ *
+ * The local player moves as soon as a key is pressed. Every input sent to the server is kept until a snapshot
+ * acknowledges it. The snapshot then gives the authoritative position, and the inputs not applied yet are
+ * replayed on top of it with the server's movement rule. The difference with the displayed position is
+ * corrected over a few frames instead of at once.
+ *
+ * Entities the local player spawns (projectiles, missiles) are predicted too: they appear when shooting and
+ * the first entity of the same kind the server creates takes them over.
+ */
+class Prediction {
+public:
+    static constexpr size_t INPUT_BUFFER_SIZE = 64;     ///< Inputs kept while waiting for their acknowledgement.
+    static constexpr float SNAP_DISTANCE = 128.0f;      ///< Corrections at least this long are applied at once.
+    static constexpr float CORRECTION_RATE = 10.0f;     ///< Rate at which the pending correction is applied, per second.
+    static constexpr std::chrono::milliseconds SPAWN_TIMEOUT{1000}; ///< Delay after which an unconfirmed spawn is dropped.
+
+    /**
+     * @brief Accounts for the local movement of a frame, not sent to the server yet.
+     *
+     * An input is sent at the end of the interval it covers: until then the local player already moved for it.
+     */
+    void accumulate(sf::Vector2f velocity, float deltaTime);
+
+    /**
+     * @brief Advances the input timer by a frame.
+     * @param interval The duration between two inputs sent.
+     * @return Whether an input is due this frame.
+     */
+    bool inputDue(float deltaTime, float interval);
+
+    /**
+     * @brief Stores an input sent to the server, until a snapshot acknowledges it.
+     * @return The sequence number the input was sent with.
+     */
+    std::uint32_t recordInput(std::uint8_t input);
+
+    /**
+     * @brief Replays the inputs the server has not applied yet, and the movement not sent yet, on top of its position.
+     * @param ackedSequence The last input the server applied, from the snapshot.
+     * @param authoritative The position of the local player in the snapshot.
+     * @param speed The player speed, on each axis.
+     * @param interval The duration every input moves the player for.
+     * @return The predicted position of the local player.
+     */
+    sf::Vector2f reconcile(std::uint32_t ackedSequence, sf::Vector2f authoritative, sf::Vector2f speed, float interval);
+
+    /**
+     * @brief Schedules the move from the displayed position to the predicted one.
+     * @return The part to apply right away: all of it for a long correction, nothing otherwise.
+     */
+    sf::Vector2f correct(sf::Vector2f displayed, sf::Vector2f predicted);
+
+    /**
+     * @brief Returns the part of the pending correction to apply this frame.
+     */
+    sf::Vector2f smooth(float deltaTime);
+
+    /**
+     * @brief Records an entity spawned locally, which the server is expected to create as well.
+     */
+    void predictSpawn(ReplicatedKind kind, core::ecs::Entity entity);
+
+    /**
+     * @brief Takes the oldest predicted entity of a kind, for the entity the server just created.
+     * @return The predicted entity, or std::nullopt if there is none.
+     */
+    std::optional<core::ecs::Entity> confirmSpawn(ReplicatedKind kind);
+
+    /**
+     * @brief Removes the predicted entities the server never created.
+     * @return The entities to kill.
+     */
+    std::vector<core::ecs::Entity> expireSpawns();
+
+    /**
+     * @brief Forgets every input and predicted entity, when leaving a game.
+     */
+    void clear();
+
+private:
+    struct PendingInput {
+        std::uint32_t sequence = 0;
+        std::uint8_t input = 0;
+    };
+
+    struct PendingSpawn {
+        core::ecs::Entity entity;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    std::array<PendingInput, INPUT_BUFFER_SIZE> _inputs{}; ///< Ring buffer of the inputs sent, by sequence number.
+    std::uint32_t _sequence = 0;                           ///< Sequence number of the last input sent.
+    std::uint32_t _ackedSequence = 0;                      ///< Last input the server applied.
+    sf::Vector2f _unsent;                                  ///< Local movement since the last input was sent.
+    float _inputTimer = 0.0f;                              ///< Time since the last input was due, in seconds.
+    sf::Vector2f _correction;                              ///< Correction not applied to the displayed position yet.
+    std::map<ReplicatedKind, std::deque<PendingSpawn>> _spawns; ///< Predicted entities by kind, oldest first.
+};
@@ -421,8 +421,8 @@ namespace Scenes {
 
         game.addToScene(EntityFactory::createGameEventManager(game));
 
-        game.setPlayerConnectionHeader(networkingService.sendRequest("127.0.0.1", 1111, PlayerConnect, {}));
-        networkingService.sendRequest("127.0.0.1", 1111, GameStart, {});
+        game.setPlayerConnectionHeader(networkingService.sendRequest(game.getServerEndpoint(), PlayerConnect, {}));
+        networkingService.sendRequest(game.getServerEndpoint(), GameStart, {});
     }
 
     void updateGame(Game &game)
@@ -432,11 +432,12 @@ namespace Scenes {
         gameEngine.registry.run_system<EventComponent>();
 
         gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent>();
+        gameEngine.registry.run_system<core::ge::TransformComponent, InterpolationComponent>();
         gameEngine.registry.run_system<core::ge::VelocityComponent, core::ge::PhysicsComponent, core::ge::GravityComponent>();
         gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent, core::ge::PhysicsComponent>();
         gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::CollisionComponent>();
 
-        gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent, Player>();
+        gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent, InputStateComponent, Player>();
         gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent, InputStateComponent, ShootCounterComponent, Player, core::ge::AnimationComponent>();
     }
 
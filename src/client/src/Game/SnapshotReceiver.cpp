@@ -0,0 +1,32 @@
+#include "SnapshotReceiver.hpp"
+
+std::optional<WorldSnapshot> SnapshotReceiver::decode(const std::vector<std::uint8_t> &payload) const
+{
+    static const WorldSnapshot empty{};
+
+    const auto baseTick = snapshot::baseTick(payload);
+    if (!baseTick)
+        return std::nullopt;
+
+    const WorldSnapshot *base = &empty;
+    if (*baseTick != 0) {
+        const auto it = _history.find(*baseTick);
+        if (it == _history.end())
+            return std::nullopt;
+        base = &it->second;
+    }
+
+    auto decoded = snapshot::decode(*base, payload);
+    if (!decoded || decoded->tick <= _latest.tick)
+        return std::nullopt;
+    return decoded;
+}
+
+void SnapshotReceiver::commit(const WorldSnapshot &snapshot, const std::uint32_t baseTick)
+{
+    _latest = snapshot;
+    _history.erase(_history.begin(), _history.lower_bound(baseTick));
+    _history.insert_or_assign(snapshot.tick, snapshot);
+    while (_history.size() > HISTORY_SIZE)
+        _history.erase(_history.begin());
+}
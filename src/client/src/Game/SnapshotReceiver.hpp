@@ -0,0 +1,45 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../core/ecs/Entity/Entity.hpp"
+#include "../../../game/Snapshot.hpp"
+
+/**
+ * @class SnapshotReceiver
+ * @brief Rebuilds the world snapshots sent by the server from their deltas.
+ *
+ * The server encodes every snapshot against the last one the client acknowledged, so the receiver keeps
+ * the snapshots it may still be asked to use as a base, and the client entity of every replicated entity.
+ */
+class SnapshotReceiver {
+public:
+    static constexpr size_t HISTORY_SIZE = 64; ///< Maximum number of snapshots kept as potential bases.
+
+    /**
+     * @brief Decodes a snapshot payload against the base it was encoded with.
+     * @return The snapshot, or std::nullopt if it is older than the latest one, its base is unknown or it is malformed.
+     */
+    std::optional<WorldSnapshot> decode(const std::vector<std::uint8_t> &payload) const;
+
+    /**
+     * @brief Records an applied snapshot as the latest one and as a base for the next deltas.
+     * @param snapshot The snapshot that was just applied.
+     * @param baseTick The tick it was encoded against: older snapshots will never be used as a base again.
+     */
+    void commit(const WorldSnapshot &snapshot, std::uint32_t baseTick);
+
+    /**
+     * @brief Returns the latest applied snapshot, or the empty baseline if none was.
+     */
+    [[nodiscard]] const WorldSnapshot &latest() const { return _latest; }
+
+    std::unordered_map<std::uint32_t, core::ecs::Entity> entities; ///< Client entity of every replicated network id.
+
+private:
+    WorldSnapshot _latest;                               ///< Latest applied snapshot.
+    std::map<std::uint32_t, WorldSnapshot> _history;     ///< Applied snapshots by tick, usable as delta bases.
+};
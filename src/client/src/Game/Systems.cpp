@@ -1,14 +1,15 @@
 #include "Systems.hpp"
 
 #include <SFML/System/Vector2.hpp>
+#include <cmath>
 #include <ostream>
-#include <queue>
 
 #include "Utils/ClientComponents.hpp"
 #include "EntityFactory.hpp"
 #include "src/event/Event.hpp"
 #include "src/event/EventPool.hpp"
 #include "../../../game/Components.hpp"
+#include "../../../game/Movement.hpp"
 #include "../../../game/RequestType.hpp"
 
 
@@ -24,6 +25,188 @@ static std::pair<std::shared_ptr<core::ge::TransformComponent>, std::shared_ptr<
     };
 }
 
+static std::optional<core::ecs::Entity> spawnEnemy(Game &game, const std::uint8_t enemyType, const sf::Vector2f &position, const std::uint16_t id)
+{
+    switch (enemyType) {
+        case 0:
+            return EntityFactory::createShooterEnemy(game, position, id);
+        case 1:
+            return EntityFactory::createEnemy(game, position, id);
+        default:
+            std::cerr << "Unknown enemy type: " << static_cast<int>(enemyType) << std::endl;
+            return std::nullopt;
+    }
+}
+
+static void killEnemy(core::ecs::Registry &registry, const core::ecs::Entity enemyEntity)
+{
+    const auto animComp = registry.get_component<core::ge::AnimationComponent>(enemyEntity);
+    registry.remove_component<core::ge::VelocityComponent>(enemyEntity);
+    registry.remove_component<core::ge::TransformComponent>(enemyEntity);
+    registry.remove_component<core::ge::CollisionComponent>(enemyEntity);
+    animComp->currentState = core::ge::AnimationState::Dying;
+    animComp->currentFrame = 0;
+    animComp->frameTime = 0.2f;
+    animComp->elapsedTime = 0.0f;
+    animComp->recurrence_max = 1;
+    animComp->recurrence_count = 0;
+    animComp->isPlaying = true;
+}
+
+/**
+ * @brief Queues a position received for a remote entity, which the interpolation system moves it to in time.
+ */
+static void pushState(core::ecs::Registry &registry, const core::ecs::Entity entity, const sf::Vector2f position)
+{
+    auto interpolation = registry.has_component<InterpolationComponent>(entity)
+        ? registry.get_component<InterpolationComponent>(entity)
+        : registry.add_component(entity, InterpolationComponent{}).value();
+
+    auto &states = interpolation->states;
+    states.push_back({std::chrono::steady_clock::now(), position});
+    if (states.size() > InterpolationComponent::MAX_STATES)
+        states.pop_front();
+}
+
+/**
+ * @brief Gives a spawned entity its client entity: the one predicted when shooting if any, a new one otherwise.
+ */
+template<typename Create>
+static core::ecs::Entity spawnPredicted(Game &game, const ReplicatedKind kind, const sf::Vector2u pos, Create create)
+{
+    auto &registry = game.getRegistry();
+    if (const auto predicted = game.getPrediction().confirmSpawn(kind)) {
+        if (const auto transform = registry.get_component<core::ge::TransformComponent>(*predicted)) {
+            transform->position = sf::Vector2f(pos);
+            return *predicted;
+        }
+    }
+    const auto entity = create(game, pos);
+    game.addToScene(entity);
+    return entity;
+}
+
+static core::ecs::Entity spawnProjectile(Game &game, const sf::Vector2u pos)
+{
+    return spawnPredicted(game, ReplicatedKind::Projectile, pos, EntityFactory::createPlayerProjectile);
+}
+
+static core::ecs::Entity spawnMissile(Game &game, const sf::Vector2u pos)
+{
+    return spawnPredicted(game, ReplicatedKind::Missile, pos, EntityFactory::createPlayerMissile);
+}
+
+/**
+ * @brief Puts a dead reckoned entity back on the motion the server replicated for it.
+ */
+static void correctMotion(core::ecs::Registry &registry, const core::ecs::Entity entity, const ReplicatedEntity &replicated, const sf::Vector2f position)
+{
+    if (const auto transform = registry.get_component<core::ge::TransformComponent>(entity))
+        transform->position = position;
+    if (const auto velocity = registry.get_component<core::ge::VelocityComponent>(entity); velocity && replicated.tick)
+        *velocity = {static_cast<float>(replicated.vx), static_cast<float>(replicated.vy)};
+}
+
+/**
+ * @brief Brings the replicated entities from the previous world snapshot to the current one.
+ *
+ * New entities are spawned, removed ones are killed and the others are moved to their server position.
+ * The server only replicates entities around the view: an enemy removed off screen left that area and
+ * disappears silently, one removed on screen died.
+ * Players are spawned by PlayerConnect and the local player moves on its own, so only remote players are moved.
+ * Remote players and enemies are interpolated between snapshots. Projectiles are dead reckoned: they keep
+ * their replicated velocity and are only moved back on their path when the server corrects their motion.
+ */
+static void applySnapshot(Game &game, const WorldSnapshot &previous, const WorldSnapshot &current)
+{
+    auto &registry = game.getRegistry();
+    const float tickDuration = current.tickSeconds();
+    auto &entities = game.getSnapshotReceiver().entities;
+    const sf::View &view = game.getGameEngine().window.getView();
+    const sf::FloatRect viewBounds(view.getCenter() - view.getSize() / 2.0f, view.getSize());
+
+    for (const auto &replicated : previous.entities) {
+        const auto *next = current.find(replicated.netId);
+        if (next && next->type == replicated.type)
+            continue;
+        const auto it = entities.find(replicated.netId);
+        if (it == entities.end())
+            continue;
+        const auto transform = registry.get_component<core::ge::TransformComponent>(it->second);
+        if (replicated.kind() == ReplicatedKind::Enemy && transform && viewBounds.intersects({transform->position, transform->size}))
+            killEnemy(registry, it->second);
+        else
+            registry.kill_entity(it->second);
+        entities.erase(it);
+    }
+
+    for (const auto &replicated : current.entities) {
+        const auto [x, y] = replicated.positionAt(current.tick, tickDuration);
+        const sf::Vector2f position(x, y);
+
+        if (replicated.kind() == ReplicatedKind::Player) {
+            for (const auto playerEntity : registry.get_entities<Player>()) {
+                const auto playerComponent = registry.get_component<Player>(playerEntity);
+                if (playerComponent->id != replicated.id() || playerComponent->self)
+                    continue;
+                pushState(registry, playerEntity, position);
+            }
+            continue;
+        }
+
+        if (const auto it = entities.find(replicated.netId); it != entities.end()) {
+            if (replicated.kind() == ReplicatedKind::Enemy)
+                pushState(registry, it->second, position);
+            else if (const auto *before = previous.find(replicated.netId); !before || *before != replicated)
+                correctMotion(registry, it->second, replicated, position);
+            continue;
+        }
+
+        std::optional<core::ecs::Entity> entity;
+        switch (replicated.kind()) {
+            case ReplicatedKind::Enemy:
+                entity = spawnEnemy(game, replicated.type, position, replicated.id());
+                if (entity) {
+                    pushState(registry, *entity, position);
+                    game.addToScene(*entity);
+                }
+                break;
+            case ReplicatedKind::Projectile:
+                entity = spawnProjectile(game, sf::Vector2u(position));
+                correctMotion(registry, *entity, replicated, position);
+                break;
+            case ReplicatedKind::Missile:
+                entity = spawnMissile(game, sf::Vector2u(position));
+                correctMotion(registry, *entity, replicated, position);
+                break;
+            default:
+                break;
+        }
+        if (entity)
+            entities.emplace(replicated.netId, *entity);
+    }
+}
+
+/**
+ * @brief Moves the local player towards where the server puts it once its pending inputs are applied.
+ */
+static void reconcile(Game &game, const core::ecs::Entity playerEntity, const WorldSnapshot &snapshot)
+{
+    auto &registry = game.getRegistry();
+    const auto &config = game.getConfigManager();
+    const auto playerComponent = registry.get_component<Player>(playerEntity);
+    const auto transform = registry.get_component<core::ge::TransformComponent>(playerEntity);
+    const auto *replicated = snapshot.find(ReplicatedEntity::makeId(ReplicatedKind::Player, playerComponent->id));
+    if (!transform || !replicated)
+        return;
+
+    const sf::Vector2f predicted = game.getPrediction().reconcile(
+        snapshot.inputSequence,
+        {static_cast<float>(replicated->x), static_cast<float>(replicated->y)},
+        {config.getValue<float>("/player/speed/x", 350.0f), config.getValue<float>("/player/speed/y", 350.0f)},
+        1.0f / std::max(config.getValue<float>("/network/inputRate", movement::DEFAULT_INPUT_RATE), 1.0f));
+    transform->position += game.getPrediction().correct(transform->position, predicted);
+}
 
 namespace Systems {
     void playerInput(Game &game)
@@ -60,42 +243,39 @@ namespace Systems {
                     }
                 }
 
-                vel = core::ge::VelocityComponent(
-                    config.getValue<float>("/player/speed/x", 350.0f) * static_cast<float>(input.right - input.left),
-                    config.getValue<float>("/player/speed/y", 350.0f) * static_cast<float>(input.down - input.up)
-                );
+                // Same rule as the server, which moves the player from the input sent to it
+                const sf::Vector2f velocity = movement::velocity(
+                    movement::pack(input.up, input.down, input.left, input.right),
+                    {config.getValue<float>("/player/speed/x", 350.0f), config.getValue<float>("/player/speed/y", 350.0f)});
+                vel = core::ge::VelocityComponent(velocity.x, velocity.y);
 
                 if (game._autoFire) {
                     autoFireTimer += gameEngine.delta_t;
                     if (autoFireTimer >= 0.3f && autoFireCount < 10) {
-                        auto selfProjectileQueue = game.getSelfProjectileQueue();
                         const auto entity = EntityFactory::createPlayerProjectile(game, {
                             static_cast<uint32_t>(transform.position.x + 99.0f),
                             static_cast<uint32_t>(transform.position.y + 15.0f)
                         });
-                        selfProjectileQueue->push(entity);
+                        game.getPrediction().predictSpawn(ReplicatedKind::Projectile, entity);
                         game.addToScene(entity);
 
                         networkingService.sendRequest(
-                            "127.0.0.1",
-                            1111,
+                            game.getServerEndpoint(),
                             PlayerProjectileShoot,
                             {player.id}
                         );
                         autoFireTimer = 0.0f;
                         autoFireCount += 1;
                     } else if (autoFireTimer >= 0.3 && autoFireCount >= 10) {
-                        auto selfMissileQueue = game.getSelfMissileQueue();
                         const auto entity = EntityFactory::createPlayerMissile(game, {
                             static_cast<uint32_t>(transform.position.x + 99.0f),
                             static_cast<uint32_t>(transform.position.y + 15.0f)
                         });
-                        selfMissileQueue->push(entity);
+                        game.getPrediction().predictSpawn(ReplicatedKind::Missile, entity);
                         game.addToScene(entity);
 
                         networkingService.sendRequest(
-                            "127.0.0.1",
-                            1111,
+                            game.getServerEndpoint(),
                             PlayerMissileShoot,
                             {player.id}
                         );
@@ -132,33 +312,29 @@ namespace Systems {
                         }
                     } else {
                         if (shootCounter.nextShotType == 0) {
-                            auto selfProjectileQueue = game.getSelfProjectileQueue();
                             const auto entity = EntityFactory::createPlayerProjectile(game, {
                                 static_cast<uint32_t>(transform.position.x + 99.0f),
                                 static_cast<uint32_t>(transform.position.y + 15.0f)
                             });
-                            selfProjectileQueue->push(entity);
+                            game.getPrediction().predictSpawn(ReplicatedKind::Projectile, entity);
                             game.addToScene(entity);
 
                             networkingService.sendRequest(
-                                "127.0.0.1",
-                                1111,
+                                game.getServerEndpoint(),
                                 PlayerProjectileShoot,
                                 {player.id}
                             );
                         }
                         if (shootCounter.nextShotType == 1) {
-                            auto selfMissileQueue = game.getSelfMissileQueue();
                             const auto entity = EntityFactory::createPlayerMissile(game, {
                                 static_cast<uint32_t>(transform.position.x + 99.0f),
                                 static_cast<uint32_t>(transform.position.y + 15.0f)
                             });
-                            selfMissileQueue->push(entity);
+                            game.getPrediction().predictSpawn(ReplicatedKind::Missile, entity);
                             game.addToScene(entity);
 
                             networkingService.sendRequest(
-                                "127.0.0.1",
-                                1111,
+                                game.getServerEndpoint(),
                                 PlayerMissileShoot,
                                 {player.id}
                             );
@@ -175,34 +351,79 @@ namespace Systems {
 
     void playerMovement(Game &game)
     {
-        auto &registry = game.getGameEngine().registry;
+        auto &gameEngine = game.getGameEngine();
+        auto &registry = gameEngine.registry;
         auto &networkingService = game.getNetworkingService();
+        auto &prediction = game.getPrediction();
+        const float inputInterval = 1.0f / std::max(game.getConfigManager().getValue<float>("/network/inputRate", movement::DEFAULT_INPUT_RATE), 1.0f);
+
+        // Only the keys are sent, at a fixed rate: the server moves the player and snapshots carry the result.
+        // The player already moved locally, snapshots only correct the prediction a little at a time.
+        registry.add_system<core::ge::TransformComponent, core::ge::VelocityComponent, InputStateComponent, Player>(
+            [&, inputInterval](core::ecs::Entity, core::ge::TransformComponent &transform, const core::ge::VelocityComponent &vel, const InputStateComponent &input, const Player &player) {
+                if (!player.self)
+                    return;
+                prediction.accumulate({vel.dx, vel.dy}, gameEngine.delta_t);
+                transform.position += prediction.smooth(gameEngine.delta_t);
 
-        registry.add_system<core::ge::TransformComponent, core::ge::VelocityComponent, Player>(
-            [&](core::ecs::Entity, const core::ge::TransformComponent &transform, const core::ge::VelocityComponent &vel, const Player &player) {
-                if (vel.dx == 0 && vel.dy == 0)
+                if (!prediction.inputDue(gameEngine.delta_t, inputInterval))
                     return;
 
-                const auto [x, y] = sf::Vector2u(transform.position);
+                const std::uint8_t bits = movement::pack(input.up, input.down, input.left, input.right);
+                const std::uint32_t sequence = prediction.recordInput(bits);
                 networkingService.sendRequest(
-                    "127.0.0.1",
-                    1111,
-                    PlayerMove,
+                    game.getServerEndpoint(),
+                    PlayerInput,
                     {
                         player.id,
-                        static_cast<uint8_t>(x >> 24),
-                        static_cast<uint8_t>(x >> 16),
-                        static_cast<uint8_t>(x >> 8),
-                        static_cast<uint8_t>(x),
-                        static_cast<uint8_t>(y >> 24),
-                        static_cast<uint8_t>(y >> 16),
-                        static_cast<uint8_t>(y >> 8),
-                        static_cast<uint8_t>(y)
+                        static_cast<uint8_t>(sequence >> 24),
+                        static_cast<uint8_t>(sequence >> 16),
+                        static_cast<uint8_t>(sequence >> 8),
+                        static_cast<uint8_t>(sequence),
+                        bits
                     }
                 );
             });
     }
 
+    void interpolation(Game &game)
+    {
+        auto &registry = game.getGameEngine().registry;
+        const auto &config = game.getConfigManager();
+        const auto delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float>(config.getValue<float>("/network/interpolationDelay", 0.1f)));
+        const auto maxExtrapolation = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<float>(config.getValue<float>("/network/maxExtrapolation", 0.25f)));
+
+        // Remote entities are shown as they were a little in the past, between the two positions received around then
+        registry.add_system<core::ge::TransformComponent, InterpolationComponent>(
+            [delay, maxExtrapolation](core::ecs::Entity, core::ge::TransformComponent &transform, InterpolationComponent &interpolation) {
+                auto &states = interpolation.states;
+                if (states.empty())
+                    return;
+
+                const auto renderTime = std::chrono::steady_clock::now() - delay;
+                while (states.size() > 2 && states[1].time <= renderTime)
+                    states.pop_front();
+
+                const auto &from = states[0];
+                if (states.size() == 1 || renderTime <= from.time) {
+                    transform.position = from.position;
+                    return;
+                }
+
+                const auto &to = states[1];
+                const float span = std::chrono::duration<float>(to.time - from.time).count();
+                if (span <= 0.0f) {
+                    transform.position = to.position;
+                    return;
+                }
+                // Past the latest position, an update was lost or is late: keep going the same way for a while
+                const auto elapsed = std::min(renderTime - from.time, (to.time - from.time) + maxExtrapolation);
+                transform.position = from.position + (to.position - from.position) * (std::chrono::duration<float>(elapsed).count() / span);
+            });
+    }
+
     void gameEvent(Game &game)
     {
         auto &gameEngine = game.getGameEngine();
@@ -214,11 +435,14 @@ namespace Systems {
                 switch (event.getType()) {
                     case PlayerConnect: {
                         const auto playerId = std::get<std::uint8_t>(event.getPayload());
+                        const bool self = event.getHeader().packetId == game.getPlayerConnectionHeader().packetId;
+                        if (self)
+                            game.getPrediction().clear();
                         game.addToScene(EntityFactory::createPlayer(
                             game,
                             gameEngine.window.getView().getSize() / 2.0f,
                             playerId,
-                            event.getHeader().packetId == game.getPlayerConnectionHeader().packetId));
+                            self));
                         game.initGameMetrics();
                         break;
                     }
@@ -226,11 +450,16 @@ namespace Systems {
                     case PlayerMove: {
                         auto [id, position] = std::get<std::pair<std::uint8_t, sf::Vector2u>>(event.getPayload());
                         for (auto playerEntity : registry.get_entities<Player>()) {
-                            if (const auto playerComponent = registry.get_component<Player>(playerEntity);
-                                playerComponent->id != id)
+                            const auto playerComponent = registry.get_component<Player>(playerEntity);
+                            if (playerComponent->id != id)
+                                continue;
+                            const sf::Vector2f playerPosition(static_cast<float>(position.x), static_cast<float>(position.y));
+                            if (!playerComponent->self) {
+                                pushState(registry, playerEntity, playerPosition);
                                 continue;
-                            const auto playerTransform = registry.get_component<core::ge::TransformComponent>(playerEntity);
-                            playerTransform->position = sf::Vector2f(static_cast<float>(position.x), static_cast<float>(position.y));
+                            }
+                            if (const auto playerTransform = registry.get_component<core::ge::TransformComponent>(playerEntity))
+                                playerTransform->position = playerPosition;
                         }
                         break;
                     }
@@ -311,56 +540,29 @@ namespace Systems {
 
                     case PlayerProjectileCreate: {
                         const auto [id, pos] = std::get<std::pair<std::uint8_t, sf::Vector2u>>(event.getPayload());
-
-                        if (auto selfProjectileQueue = game.getSelfProjectileQueue();
-                            !selfProjectileQueue->empty()) {
-                            auto projectile = selfProjectileQueue->front();
-                            selfProjectileQueue->pop();
-                            registry.kill_entity(projectile);
-                        }
-                        game.addToScene(EntityFactory::createPlayerProjectile(game, pos));
+                        spawnProjectile(game, pos);
                         break;
                     }
 
                     case PlayerMissileCreate: {
                         const auto [id, pos] = std::get<std::pair<std::uint8_t, sf::Vector2u>>(event.getPayload());
-
-                        if (auto selfMissileQueue = game.getSelfMissileQueue();
-                            !selfMissileQueue->empty()) {
-                            auto missile = selfMissileQueue->front();
-                            selfMissileQueue->pop();
-                            registry.kill_entity(missile);
-                        }
-                        game.addToScene(EntityFactory::createPlayerMissile(game, pos));
+                        spawnMissile(game, pos);
                         break;
                     }
 
                     case EnemySpawn: {
                         auto [id, enemyType, position] = std::get<std::tuple<std::uint8_t, std::uint8_t, sf::Vector2u>>(event.getPayload());
-                        switch (enemyType) {
-                            case 0:
-                                game.addToScene(EntityFactory::createShooterEnemy(game, sf::Vector2f(position), id));
-                                break;
-                            case 1:
-                                game.addToScene(EntityFactory::createEnemy(game, sf::Vector2f(position), id));
-                                break;
-                            default:
-                                std::cerr << "Unknown enemy type: " << static_cast<int>(enemyType) << std::endl;
-                                break;
-                        }
+                        if (const auto enemy = spawnEnemy(game, enemyType, sf::Vector2f(position), id))
+                            game.addToScene(*enemy);
                         break;
                     }
 
                     case EnemyMove: {
                         auto [id, position] = std::get<std::pair<std::uint8_t, sf::Vector2u>>(event.getPayload());
-                        for (auto enemyEntity : registry.get_entities<Enemy>()) {
-                            if (registry.get_component<Enemy>(enemyEntity)->id == id)
-                                return;
-
-                            const auto enemyTransform = registry.get_component<core::ge::TransformComponent>(enemyEntity);
-                            if (!enemyTransform)
-                                return;
-                            enemyTransform->position = sf::Vector2f(static_cast<float>(position.x), static_cast<float>(position.y));
+                        for (auto enemyEntity : registry.get_entities<Enemy, core::ge::TransformComponent>()) {
+                            if (registry.get_component<Enemy>(enemyEntity)->id != id)
+                                continue;
+                            pushState(registry, enemyEntity, sf::Vector2f(static_cast<float>(position.x), static_cast<float>(position.y)));
                         }
                         break;
                     }
@@ -370,18 +572,40 @@ namespace Systems {
                         for (auto enemyEntity : registry.get_entities<Enemy>()) {
                             if (registry.get_component<Enemy>(enemyEntity)->id != enemyDiePayload)
                                 continue;
+                            killEnemy(registry, enemyEntity);
+                        }
+                        break;
+                    }
 
-                            const auto animComp = registry.get_component<core::ge::AnimationComponent>(enemyEntity);
-                            registry.remove_component<core::ge::VelocityComponent>(enemyEntity);
-                            registry.remove_component<core::ge::TransformComponent>(enemyEntity);
-                            registry.remove_component<core::ge::CollisionComponent>(enemyEntity);
-                            animComp->currentState = core::ge::AnimationState::Dying;
-                            animComp->currentFrame = 0;
-                            animComp->frameTime = 0.2f;
-                            animComp->elapsedTime = 0.0f;
-                            animComp->recurrence_max = 1;
-                            animComp->recurrence_count = 0;
-                            animComp->isPlaying = true;
+                    case Snapshot: {
+                        const auto &payload = std::get<std::vector<std::uint8_t>>(event.getPayload());
+                        auto &receiver = game.getSnapshotReceiver();
+                        const auto snapshot = receiver.decode(payload);
+                        if (!snapshot)
+                            break;
+
+                        applySnapshot(game, receiver.latest(), *snapshot);
+                        receiver.commit(*snapshot, *snapshot::baseTick(payload));
+                        for (const auto expired : game.getPrediction().expireSpawns())
+                            registry.kill_entity(expired);
+
+                        for (const auto playerEntity : registry.get_entities<Player>()) {
+                            const auto playerComponent = registry.get_component<Player>(playerEntity);
+                            if (!playerComponent->self)
+                                continue;
+                            reconcile(game, playerEntity, *snapshot);
+                            const std::uint32_t tick = snapshot->tick;
+                            game.getNetworkingService().sendRequest(
+                                game.getServerEndpoint(),
+                                SnapshotAck,
+                                {
+                                    playerComponent->id,
+                                    static_cast<uint8_t>(tick >> 24),
+                                    static_cast<uint8_t>(tick >> 16),
+                                    static_cast<uint8_t>(tick >> 8),
+                                    static_cast<uint8_t>(tick)
+                                });
+                            break;
                         }
                         break;
                     }
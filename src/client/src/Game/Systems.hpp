@@ -6,6 +6,7 @@
 namespace Systems {
     void playerInput(Game &game);
     void playerMovement(Game &game);
+    void interpolation(Game &game);
     void gameEvent(Game &game);
     void gameView(Game &game);
     void hitAnimation(Game &game);
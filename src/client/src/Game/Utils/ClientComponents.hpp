@@ -3,6 +3,8 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <chrono>
+#include <deque>
 
 /**
  * @struct ViewComponent
@@ -31,4 +33,22 @@ struct HitAnimationComponent {
     bool isTransparent;
 };
 
+/**
+ * @struct InterpolationComponent
+ * @brief Positions received from the server for a remote entity, which is rendered a little in the past.
+ *
+ * Rendering behind the latest update leaves two received positions to interpolate between, so remote
+ * entities move smoothly whatever the rate the server sends at.
+ */
+struct InterpolationComponent {
+    struct State {
+        std::chrono::steady_clock::time_point time; ///< When the position was received.
+        sf::Vector2f position;                      ///< Position sent by the server.
+    };
+
+    static constexpr size_t MAX_STATES = 32; ///< Received positions kept at most.
+
+    std::deque<State> states; ///< Received positions, oldest first.
+};
+
 #endif /* !CLIENTCOMPONENTS_HPP_ */
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <string>
 #include <variant>
+#include <vector>
 #include <ostream>
 #include "../../../game/RequestType.hpp"
 #include "../../../core/network/NetworkService.hpp"
@@ -42,7 +43,8 @@ public:
         std::pair<std::uint8_t, sf::Vector2u>,
         std::tuple<std::uint8_t, std::uint8_t, sf::Vector2u>,
         std::uint32_t,
-        std::uint8_t> payload_t;
+        std::uint8_t,
+        std::vector<std::uint8_t>> payload_t;
 
     /**
      * @brief Constructor for an event without a payload.
@@ -129,6 +131,9 @@ public:
             case RequestType::TileDestroy:
                 os << "TileDestroy";
                 break;
+            case RequestType::Snapshot:
+                os << "Snapshot";
+                break;
             default:
                 os << "Unknown{" << event.type << "}";
                 break;
@@ -155,6 +160,8 @@ public:
                 os << "uint32_t{" << payload << "}";
             } else if constexpr (std::is_same_v<T, std::uint8_t>) {
                 os << "uint8_t{" << static_cast<int>(payload) << "}";
+            } else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>) {
+                os << "bytes{size=" << payload.size() << "}";
             } else {
                 static_assert(always_false<T>::value, "non-exhaustive visitor!");
             }
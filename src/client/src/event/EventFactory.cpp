@@ -25,9 +25,10 @@ const std::unordered_map<uint8_t, EventFactory::EventHandler> EventFactory::hand
     {RequestType::EnemySpawn, handleEnemySpawn},
     {RequestType::EnemyMove, handleEnemyMove},
     {RequestType::EnemyDie, handleEnemyDie},
+    {RequestType::Snapshot, handleSnapshot},
 };
 
-Event EventFactory::createEvent(const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::createEvent(const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (const auto it = handlers.find(header.messageType); it != handlers.end()) {
         return it->second(header, payload);
@@ -36,7 +37,7 @@ Event EventFactory::createEvent(const GDTPHeader& header, const std::vector<uint
     throw EventPool::UnknownEvent(header.messageType);
 }
 
-Event EventFactory::handleMapScroll([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handleMapScroll([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 4) {
         throw std::runtime_error("Invalid payload size for MapScroll event");
@@ -45,7 +46,7 @@ Event EventFactory::handleMapScroll([[maybe_unused]] const GDTPHeader& header, c
     return {RequestType::MapScroll, header, mapScroll};
 }
 
-Event EventFactory::handleTileDestroy([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handleTileDestroy([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 8) {
         throw std::runtime_error("Invalid payload size for TileDestroy event");
@@ -55,7 +56,7 @@ Event EventFactory::handleTileDestroy([[maybe_unused]] const GDTPHeader& header,
     return {RequestType::TileDestroy, header, sf::Vector2u{x, y}};
 }
 
-Event EventFactory::handlePlayerProjectileCreate([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerProjectileCreate([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 9) {
         throw std::runtime_error("Invalid payload size for PlayerProjectileCreate event");
@@ -66,7 +67,7 @@ Event EventFactory::handlePlayerProjectileCreate([[maybe_unused]] const GDTPHead
     return {RequestType::PlayerProjectileCreate, header, std::make_pair(projectileId, sf::Vector2u{x, y})};
 }
 
-Event EventFactory::handlePlayerMissileCreate([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerMissileCreate([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 9) {
         throw std::runtime_error("Invalid payload size for PlayerMissileCreate event");
@@ -77,7 +78,7 @@ Event EventFactory::handlePlayerMissileCreate([[maybe_unused]] const GDTPHeader&
     return {RequestType::PlayerMissileCreate, header, std::make_pair(missileId, sf::Vector2u{x, y})};
 }
 
-Event EventFactory::handlePlayerProjectileDestroy([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerProjectileDestroy([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 1) {
         throw std::runtime_error("Invalid payload size for PlayerProjectileDestroy event");
@@ -86,7 +87,7 @@ Event EventFactory::handlePlayerProjectileDestroy([[maybe_unused]] const GDTPHea
     return {RequestType::PlayerProjectileDestroy, header, projectileId};
 }
 
-Event EventFactory::handlePlayerMissileDestroy([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerMissileDestroy([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 1) {
         throw std::runtime_error("Invalid payload size for PlayerMissileDestroy event");
@@ -95,7 +96,7 @@ Event EventFactory::handlePlayerMissileDestroy([[maybe_unused]] const GDTPHeader
     return {RequestType::PlayerMissileDestroy, header, missileId};
 }
 
-Event EventFactory::handlePlayerMove([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerMove([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 9) {
         throw std::runtime_error("Invalid payload size for PlayerMove event");
@@ -106,7 +107,7 @@ Event EventFactory::handlePlayerMove([[maybe_unused]] const GDTPHeader& header,
     return {RequestType::PlayerMove, header, std::make_pair(playerId, sf::Vector2u{x, y})};
 }
 
-Event EventFactory::handlePlayerCollide([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerCollide([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 9) {
         throw std::runtime_error("Invalid payload size for PlayerCollide event");
@@ -117,7 +118,7 @@ Event EventFactory::handlePlayerCollide([[maybe_unused]] const GDTPHeader& heade
     return {RequestType::PlayerCollide, header, std::make_pair(playerId, sf::Vector2u{x, y})};
 }
 
-Event EventFactory::handlePlayerHit([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerHit([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 1) {
         throw std::runtime_error("Invalid payload size for PlayerHit event");
@@ -126,7 +127,7 @@ Event EventFactory::handlePlayerHit([[maybe_unused]] const GDTPHeader& header, c
     return {RequestType::PlayerHit, header, playerId};
 }
 
-Event EventFactory::handlePlayerDie([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerDie([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 1) {
         throw std::runtime_error("Invalid payload size for PlayerDie event");
@@ -135,7 +136,7 @@ Event EventFactory::handlePlayerDie([[maybe_unused]] const GDTPHeader& header, c
     return {RequestType::PlayerDie, header, playerId};
 }
 
-Event EventFactory::handleEnemySpawn([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handleEnemySpawn([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 10) {
         throw std::runtime_error("Invalid payload size for EnemySpawn event");
@@ -147,7 +148,7 @@ Event EventFactory::handleEnemySpawn([[maybe_unused]] const GDTPHeader& header,
     return {RequestType::EnemySpawn, header, std::make_tuple(enemyId, enemyType, sf::Vector2u{x, y})};
 }
 
-Event EventFactory::handleEnemyMove([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handleEnemyMove([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 9) {
         throw std::runtime_error("Invalid payload size for EnemyMove event");
@@ -158,7 +159,7 @@ Event EventFactory::handleEnemyMove([[maybe_unused]] const GDTPHeader& header, c
     return {RequestType::EnemyMove, header, std::make_pair(enemyId, sf::Vector2u{x, y})};
 }
 
-Event EventFactory::handleEnemyDie([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handleEnemyDie([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 1) {
         throw std::runtime_error("Invalid payload size for EnemyDie event");
@@ -167,7 +168,17 @@ Event EventFactory::handleEnemyDie([[maybe_unused]] const GDTPHeader& header, co
     return {RequestType::EnemyDie, header, enemyId};
 }
 
-Event EventFactory::handlePlayerConnect([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handleSnapshot([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
+{
+    // Deltas are decoded by the game against its snapshot history, the payload is forwarded as is:
+    // it is copied out of the receive buffer, which the next datagram overwrites
+    if (payload.size() < 16) {
+        throw std::runtime_error("Invalid payload size for Snapshot event");
+    }
+    return {RequestType::Snapshot, header, std::vector<uint8_t>(payload.begin(), payload.end())};
+}
+
+Event EventFactory::handlePlayerConnect([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 1) {
         throw std::runtime_error("Invalid payload size for PlayerConnect event");
@@ -176,7 +187,7 @@ Event EventFactory::handlePlayerConnect([[maybe_unused]] const GDTPHeader& heade
     return {RequestType::PlayerConnect, header, playerId};
 }
 
-Event EventFactory::handlePlayerDisconnect([[maybe_unused]] const GDTPHeader& header, const std::vector<uint8_t>& payload)
+Event EventFactory::handlePlayerDisconnect([[maybe_unused]] const GDTPHeader& header, std::span<const uint8_t> payload)
 {
     if (payload.size() != 1) {
         throw std::runtime_error("Invalid payload size for PlayerDisconnect event");
@@ -185,7 +196,7 @@ Event EventFactory::handlePlayerDisconnect([[maybe_unused]] const GDTPHeader& he
     return {RequestType::PlayerDisconnect, header, playerId};
 }
 
-Event EventFactory::handleGameStart([[maybe_unused]] const GDTPHeader& header, [[maybe_unused]] const std::vector<uint8_t>& payload)
+Event EventFactory::handleGameStart([[maybe_unused]] const GDTPHeader& header, [[maybe_unused]] std::span<const uint8_t> payload)
 {
     if (!payload.empty()) {
         throw std::runtime_error("Invalid payload size for GameStart event");
@@ -193,7 +204,7 @@ Event EventFactory::handleGameStart([[maybe_unused]] const GDTPHeader& header, [
     return {RequestType::GameStart, header};
 }
 
-Event EventFactory::handleGameOver([[maybe_unused]] const GDTPHeader& header, [[maybe_unused]] const std::vector<uint8_t>& payload)
+Event EventFactory::handleGameOver([[maybe_unused]] const GDTPHeader& header, [[maybe_unused]] std::span<const uint8_t> payload)
 {
     if (!payload.empty()) {
         throw std::runtime_error("Invalid payload size for GameOver event");
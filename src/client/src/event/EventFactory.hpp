@@ -5,6 +5,7 @@
 #include "../core/network/includes/RequestHeader.hpp"
 #include <unordered_map>
 #include <functional>
+#include <span>
 
 /**
  * @class EventFactory
@@ -27,29 +28,30 @@ public:
      * @return A fully constructed Event object corresponding to the GDTPMessageType.
      * @throws UnknownEvent if the messageType is invalid or unsupported.
      */
-    static Event createEvent(const GDTPHeader& header, const std::vector<uint8_t>& payload);
+    static Event createEvent(const GDTPHeader& header, std::span<const uint8_t> payload);
 
 private:
-    using EventHandler = std::function<Event(const GDTPHeader&, const std::vector<uint8_t>&)>;
+    using EventHandler = std::function<Event(const GDTPHeader&, std::span<const uint8_t>)>;
     static const std::unordered_map<uint8_t, EventHandler> handlers;
 
-    static Event handlePlayerConnect(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerDisconnect(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handleGameStart(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handleGameOver(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handleMapScroll(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handleTileDestroy(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerProjectileCreate(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerMissileCreate(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerProjectileDestroy(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerMissileDestroy(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerMove(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerCollide(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerHit(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handlePlayerDie(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handleEnemySpawn(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handleEnemyMove(const GDTPHeader& header, const std::vector<uint8_t>& payload);
-    static Event handleEnemyDie(const GDTPHeader& header, const std::vector<uint8_t>& payload);
+    static Event handlePlayerConnect(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerDisconnect(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleGameStart(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleGameOver(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleMapScroll(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleTileDestroy(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerProjectileCreate(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerMissileCreate(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerProjectileDestroy(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerMissileDestroy(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerMove(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerCollide(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerHit(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handlePlayerDie(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleEnemySpawn(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleEnemyMove(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleEnemyDie(const GDTPHeader& header, std::span<const uint8_t> payload);
+    static Event handleSnapshot(const GDTPHeader& header, std::span<const uint8_t> payload);
 };
 
 #endif // EVENTFACTORY_HPP
@@ -10,6 +10,8 @@
 
 #include "../../../core/network/NetworkService.hpp"
 #include "EventFactory.hpp"
+#include "../../../game/Batch.hpp"
+#include "../../../game/RequestType.hpp"
 
 
 class NetworkingService;
@@ -43,8 +45,25 @@ bool EventPool::isEmpty() const {
     return eventQueue.empty();
 }
 
-void EventPool::handler(const GDTPHeader &header, const std::vector<uint8_t> &payload,
+void EventPool::handler(const GDTPHeader &header, const std::span<const uint8_t> payload,
                        [[maybe_unused]] const asio::ip::udp::endpoint &client_endpoint) {
+    if (header.messageType == RequestType::Batch) {
+        // Each coalesced message becomes its own event, as if it had its own datagram
+        const bool valid = batch::forEach(payload, [&](const uint8_t messageType, const std::span<const uint8_t> message) {
+            GDTPHeader messageHeader = header;
+            messageHeader.messageType = messageType;
+            messageHeader.payloadSize = static_cast<uint16_t>(message.size());
+            // Envelopes of the reliable and sequenced channels are opened by the networking service
+            if (messageType == RequestType::Envelope)
+                NetworkingService::getInstance().dispatch(messageHeader, message, client_endpoint);
+            else
+                handler(messageHeader, message, client_endpoint);
+        });
+        if (!valid)
+            std::cerr << "Error: Malformed batch payload" << std::endl;
+        return;
+    }
+
     try {
         EventPool::getInstance().pushEvent(EventFactory::createEvent(header, payload));
     } catch (const std::exception &e) {
@@ -6,6 +6,7 @@
 #include <mutex>
 #include <optional>
 #include <deque>
+#include <span>
 #include <vector>
 
 #include "../../../core/network/NetworkService.hpp"
@@ -49,10 +50,10 @@ class EventPool {
          * @brief Event handler function for processing GDTP messages.
          *
          * @param header The header of the received message.
-         * @param payload The payload of the message.
+         * @param payload The payload of the message, a view into the receive buffer valid during the call.
          * @param client_endpoint The client endpoint from which the message was received.
          */
-        static void handler(const GDTPHeader& header, const std::vector<uint8_t>& payload, const asio::ip::udp::endpoint& client_endpoint);
+        static void handler(const GDTPHeader& header, std::span<const uint8_t> payload, const asio::ip::udp::endpoint& client_endpoint);
 
         /**
          * @brief Sets a new handler to be called when an event is pushed.
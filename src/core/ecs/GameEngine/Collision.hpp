@@ -0,0 +1,510 @@
+#ifndef COLLISION_HPP_
+#define COLLISION_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "../Entity/Entity.hpp"
+#include "../SparseArray/SparseArray.hpp"
+#include "./GameEngineComponents.hpp"
+#include "./WorkerPool.hpp"
+
+namespace core::ge {
+
+/**
+ * @enum ContactState
+ * @brief Lifecycle of a contact between two colliders across ticks.
+ */
+enum class ContactState : uint8_t {
+    Enter, ///< The pair started overlapping this tick.
+    Stay,  ///< The pair was already overlapping on the previous tick.
+    Exit,  ///< The pair overlapped on the previous tick but no longer does.
+};
+
+/**
+ * @struct Contact
+ * @brief A single, deduplicated collision event between two entities.
+ *
+ * `first` always holds the lower entity id, so a pair is only ever reported once per tick.
+ */
+struct Contact {
+    ecs::Entity first;
+    ecs::Entity second;
+    ContactState state;
+    float timeOfImpact = 1.0f; ///< Fraction of the tick at which the pair first touched, 1 when only tested at the end of the tick.
+};
+
+/**
+ * @brief Computes the world-space rectangle of a collision box.
+ *
+ * @param box The collision box, relative to the entity.
+ * @param transform The transform of the entity owning the box.
+ * @return The box translated and scaled into world space.
+ */
+inline sf::FloatRect worldRect(const sf::FloatRect &box, const TransformComponent &transform)
+{
+    return {
+        box.left + transform.position.x,
+        box.top + transform.position.y,
+        box.width * transform.scale.x,
+        box.height * transform.scale.y
+    };
+}
+
+/**
+ * @class ContactTracker
+ * @brief Turns the overlapping pairs found during a scan into enter/stay/exit contacts.
+ *
+ * Pairs are recorded between `begin()` and `end()`. `end()` compares them against the pairs of the
+ * previous tick and produces the contact list, ordered by time of impact then by pair, so dispatch
+ * is deterministic and follows the order in which things touched during the tick.
+ */
+class ContactTracker {
+public:
+    /**
+     * @brief Starts a new scan, forgetting the pairs recorded so far.
+     */
+    void begin()
+    {
+        _hits.clear();
+    }
+
+    /**
+     * @brief Records an overlapping pair. The order of the two entities does not matter.
+     *
+     * @param a The first entity of the pair.
+     * @param b The second entity of the pair.
+     * @param timeOfImpact The fraction of the tick at which the pair first touched.
+     */
+    void add(const size_t a, const size_t b, const float timeOfImpact = 1.0f)
+    {
+        _hits.emplace_back(key(std::min(a, b), std::max(a, b)), timeOfImpact);
+    }
+
+    /**
+     * @brief Ends the scan and computes the contacts for this tick.
+     *
+     * @return The contacts, ordered by time of impact then by pair.
+     */
+    const std::vector<Contact> &end()
+    {
+        // Sorting by pair then time keeps the earliest impact of each pair first.
+        std::ranges::sort(_hits);
+        _hits.erase(std::ranges::unique(_hits, {}, &Hit::first).begin(), _hits.end());
+
+        _contacts.clear();
+        _current.clear();
+        auto previous = _previous.begin();
+        for (const auto &[pair, timeOfImpact] : _hits) {
+            for (; previous != _previous.end() && *previous < pair; ++previous)
+                push(*previous, ContactState::Exit, 1.0f);
+            if (previous != _previous.end() && *previous == pair) {
+                push(pair, ContactState::Stay, timeOfImpact);
+                ++previous;
+            } else {
+                push(pair, ContactState::Enter, timeOfImpact);
+            }
+            _current.push_back(pair);
+        }
+        for (; previous != _previous.end(); ++previous)
+            push(*previous, ContactState::Exit, 1.0f);
+        std::ranges::stable_sort(_contacts, {}, &Contact::timeOfImpact);
+
+        std::swap(_previous, _current);
+        return _contacts;
+    }
+
+    /**
+     * @brief Gets the contacts computed by the last call to `end()`.
+     */
+    [[nodiscard]] const std::vector<Contact> &contacts() const { return _contacts; }
+
+private:
+    static uint64_t key(const size_t a, const size_t b)
+    {
+        return static_cast<uint64_t>(a) << 32 | static_cast<uint32_t>(b);
+    }
+
+    void push(const uint64_t pair, const ContactState state, const float timeOfImpact)
+    {
+        _contacts.push_back({ecs::Entity{static_cast<size_t>(pair >> 32)}, ecs::Entity{static_cast<size_t>(pair & 0xFFFFFFFF)}, state, timeOfImpact});
+    }
+
+    using Hit = std::pair<uint64_t, float>;
+
+    std::vector<Hit> _hits;          ///< Pairs recorded during the current scan, with their time of impact.
+    std::vector<uint64_t> _previous; ///< Sorted pairs overlapping on the previous tick.
+    std::vector<uint64_t> _current;  ///< Sorted pairs overlapping on the current tick.
+    std::vector<Contact> _contacts;  ///< Contacts produced by the last scan.
+};
+
+/**
+ * @enum Broadphase
+ * @brief Algorithms available to find the candidate pairs handed to the narrowphase.
+ */
+enum class Broadphase : uint8_t {
+    BruteForce,    ///< Tests every pair of colliders.
+    SweepAndPrune, ///< Sorts colliders along the x axis and only tests those overlapping on it.
+};
+
+/**
+ * @struct CollisionStats
+ * @brief Counters describing the work done by the last collision scan.
+ */
+struct CollisionStats {
+    size_t colliders = 0;   ///< Colliders snapshotted.
+    size_t pairsTested = 0; ///< Pairs whose bounds the broadphase compared.
+    size_t candidates = 0;  ///< Pairs handed to the narrowphase.
+    size_t contacts = 0;    ///< Pairs found overlapping by the narrowphase.
+};
+
+/**
+ * @struct Collider
+ * @brief Flat snapshot of a collider taken at the start of a scan.
+ */
+struct Collider {
+    size_t entity;                         ///< The entity owning the collider.
+    uint32_t mask;                         ///< The collision mask of the entity.
+    uint32_t listens;                      ///< Union of the masks of the entity callbacks.
+    sf::FloatRect bounds;                  ///< World-space bounds of every box of the entity.
+    const CollisionComponent *collision;   ///< The collision component of the entity.
+    const TransformComponent *transform;   ///< The transform component of the entity.
+    sf::Vector2f displacement;             ///< Movement swept during the tick, zero for discrete colliders.
+};
+
+/**
+ * @brief Checks whether any box of a collider overlaps the static colliders of another one.
+ */
+inline bool intersectsStatic(const Collider &staticCollider, const Collider &other)
+{
+    const sf::Vector2f &origin = staticCollider.transform->position;
+    for (const auto &box : other.collision->collisionBoxes) {
+        sf::FloatRect rect = worldRect(box, *other.transform);
+        rect.left -= origin.x;
+        rect.top -= origin.y;
+        if (staticCollider.collision->staticColliders->overlaps(rect))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Checks whether any box of a collider overlaps any box of another collider.
+ */
+inline bool intersects(const Collider &a, const Collider &b)
+{
+    if (a.collision->staticColliders)
+        return intersectsStatic(a, b);
+    if (b.collision->staticColliders)
+        return intersectsStatic(b, a);
+
+    for (const auto &box : a.collision->collisionBoxes) {
+        const sf::FloatRect rect = worldRect(box, *a.transform);
+        for (const auto &otherBox : b.collision->collisionBoxes) {
+            if (rect.intersects(worldRect(otherBox, *b.transform)))
+                return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Computes when a moving rectangle first overlaps a still one.
+ *
+ * @param rect The moving rectangle, at its start position.
+ * @param displacement The movement of the rectangle over the tick.
+ * @param other The still rectangle.
+ * @return The fraction of the tick at which they start overlapping, if they do during the tick.
+ */
+inline std::optional<float> sweep(const sf::FloatRect &rect, const sf::Vector2f displacement, const sf::FloatRect &other)
+{
+    float entry = -std::numeric_limits<float>::infinity();
+    float exit = std::numeric_limits<float>::infinity();
+
+    const auto axis = [&](const float start, const float size, const float delta, const float otherStart, const float otherSize) {
+        if (delta == 0)
+            return start < otherStart + otherSize && otherStart < start + size;
+        float enter = (otherStart - (start + size)) / delta;
+        float leave = (otherStart + otherSize - start) / delta;
+        if (enter > leave)
+            std::swap(enter, leave);
+        entry = std::max(entry, enter);
+        exit = std::min(exit, leave);
+        return true;
+    };
+
+    if (!axis(rect.left, rect.width, displacement.x, other.left, other.width)
+        || !axis(rect.top, rect.height, displacement.y, other.top, other.height))
+        return std::nullopt;
+    if (entry >= exit || entry >= 1 || exit <= 0)
+        return std::nullopt;
+    return std::max(entry, 0.0f);
+}
+
+/**
+ * @brief Sweeps the boxes of a moving collider against the static colliders of another one.
+ */
+inline std::optional<float> sweepStatic(const Collider &moving, const Collider &staticCollider)
+{
+    const sf::Vector2f origin = staticCollider.transform->position - staticCollider.displacement;
+    const sf::Vector2f displacement = moving.displacement - staticCollider.displacement;
+
+    std::optional<float> first;
+    for (const auto &box : moving.collision->collisionBoxes) {
+        sf::FloatRect start = worldRect(box, *moving.transform);
+        start.left -= moving.displacement.x + origin.x;
+        start.top -= moving.displacement.y + origin.y;
+
+        const sf::FloatRect area = {
+            start.left + std::min(displacement.x, 0.0f),
+            start.top + std::min(displacement.y, 0.0f),
+            start.width + std::abs(displacement.x),
+            start.height + std::abs(displacement.y)
+        };
+        staticCollider.collision->staticColliders->query(area, [&](const sf::FloatRect &rect) {
+            if (const auto time = sweep(start, displacement, rect); time && (!first || *time < *first))
+                first = time;
+            return true;
+        });
+    }
+    return first;
+}
+
+/**
+ * @brief Computes when two colliders first overlap during the tick.
+ *
+ * Discrete pairs are only tested at their current position and report a time of 1. As soon as one
+ * side has moved continuously, boxes are swept from their start position using the relative motion.
+ *
+ * @return The time of impact, if the colliders overlap during the tick.
+ */
+inline std::optional<float> timeOfImpact(const Collider &a, const Collider &b)
+{
+    if (a.displacement == sf::Vector2f(0, 0) && b.displacement == sf::Vector2f(0, 0))
+        return intersects(a, b) ? std::optional(1.0f) : std::nullopt;
+    if (b.collision->staticColliders)
+        return sweepStatic(a, b);
+    if (a.collision->staticColliders)
+        return sweepStatic(b, a);
+
+    const sf::Vector2f displacement = a.displacement - b.displacement;
+    std::optional<float> first;
+    for (const auto &box : a.collision->collisionBoxes) {
+        sf::FloatRect start = worldRect(box, *a.transform);
+        start.left -= a.displacement.x;
+        start.top -= a.displacement.y;
+        for (const auto &otherBox : b.collision->collisionBoxes) {
+            sf::FloatRect otherStart = worldRect(otherBox, *b.transform);
+            otherStart.left -= b.displacement.x;
+            otherStart.top -= b.displacement.y;
+            if (const auto time = sweep(start, displacement, otherStart); time && (!first || *time < *first))
+                first = time;
+        }
+    }
+    return first;
+}
+
+/**
+ * @class CollisionDetector
+ * @brief Finds the contacts between colliders, in three steps.
+ *
+ * Colliders are first snapshotted into a flat array. The broadphase then keeps the pairs whose
+ * bounds overlap and where at least one side has a callback for the other, and the narrowphase
+ * tests their boxes, sweeping them for entities with a `ContinuousCollisionComponent`. The narrowphase can
+ * be split across a worker pool: every worker fills its own buffer, and buffers are merged in worker order
+ * so the result does not depend on scheduling.
+ */
+class CollisionDetector {
+public:
+    /**
+     * @brief Selects the broadphase algorithm.
+     */
+    void setBroadphase(const Broadphase broadphase) { _broadphase = broadphase; }
+
+    /**
+     * @brief Sets the number of threads running the narrowphase. 0 or 1 runs it on the calling thread.
+     */
+    void setThreads(const size_t threads)
+    {
+        _pool = threads > 1 ? std::make_unique<WorkerPool>(threads) : nullptr;
+        _buffers.assign(_pool ? _pool->size() : 1, {});
+    }
+
+    /**
+     * @brief Scans the colliders and computes the contacts of this tick.
+     *
+     * @param collisions The collision components of the registry.
+     * @param transforms The transform components of the registry.
+     * @param continuous The continuous collision components of the registry.
+     * @return The contacts, ordered by time of impact then by pair.
+     */
+    const std::vector<Contact> &detect(
+        ecs::SparseArray<std::shared_ptr<CollisionComponent>> &collisions,
+        ecs::SparseArray<std::shared_ptr<TransformComponent>> &transforms,
+        ecs::SparseArray<std::shared_ptr<ContinuousCollisionComponent>> &continuous)
+    {
+        snapshot(collisions, transforms, continuous);
+
+        _stats = {_colliders.size()};
+        _candidates.clear();
+        if (_broadphase == Broadphase::SweepAndPrune)
+            sweepAndPrune();
+        else
+            bruteForce();
+        _stats.candidates = _candidates.size();
+
+        narrowphase();
+
+        _tracker.begin();
+        for (const auto &buffer : _buffers) {
+            _stats.contacts += buffer.size();
+            for (const auto &[a, b, timeOfImpact] : buffer)
+                _tracker.add(_colliders[a].entity, _colliders[b].entity, timeOfImpact);
+        }
+        return _tracker.end();
+    }
+
+    /**
+     * @brief Gets the counters of the last scan.
+     */
+    [[nodiscard]] const CollisionStats &stats() const { return _stats; }
+
+    /**
+     * @brief Gets the contacts computed by the last scan.
+     */
+    [[nodiscard]] const std::vector<Contact> &contacts() const { return _tracker.contacts(); }
+
+private:
+    using Pair = std::pair<uint32_t, uint32_t>;
+
+    /**
+     * @brief A candidate pair that passed the narrowphase.
+     */
+    struct Hit {
+        uint32_t a;
+        uint32_t b;
+        float timeOfImpact;
+    };
+
+    /// Below this many candidates per worker, the narrowphase stays on the calling thread.
+    static constexpr size_t MIN_PAIRS_PER_WORKER = 64;
+
+    void snapshot(
+        ecs::SparseArray<std::shared_ptr<CollisionComponent>> &collisions,
+        ecs::SparseArray<std::shared_ptr<TransformComponent>> &transforms,
+        const ecs::SparseArray<std::shared_ptr<ContinuousCollisionComponent>> &continuous)
+    {
+        _colliders.clear();
+        for (size_t i = 0; i < collisions.size(); ++i) {
+            if (!collisions[i].has_value() || !transforms[i].has_value())
+                continue;
+
+            const auto &collision = *collisions[i];
+            const auto &transform = *transforms[i];
+            if (collision->collisionBoxes.empty())
+                continue;
+
+            Collider collider{i, collision->collisionMask, 0, worldRect(collision->collisionBoxes.front(), *transform), collision.get(), transform.get(), {0, 0}};
+            for (const auto &box : collision->collisionBoxes) {
+                const sf::FloatRect rect = worldRect(box, *transform);
+                const float right = std::max(collider.bounds.left + collider.bounds.width, rect.left + rect.width);
+                const float bottom = std::max(collider.bounds.top + collider.bounds.height, rect.top + rect.height);
+                collider.bounds.left = std::min(collider.bounds.left, rect.left);
+                collider.bounds.top = std::min(collider.bounds.top, rect.top);
+                collider.bounds.width = right - collider.bounds.left;
+                collider.bounds.height = bottom - collider.bounds.top;
+            }
+            for (const auto &[mask, _] : collision->onCollision)
+                collider.listens |= mask;
+            for (const auto &[mask, _] : collision->onSeparation)
+                collider.listens |= mask;
+
+            if (const auto &sweeping = continuous[i]; sweeping.has_value() && (*sweeping)->hasPreviousPosition) {
+                collider.displacement = transform->position - (*sweeping)->previousPosition;
+                const float left = collider.bounds.left - std::max(collider.displacement.x, 0.0f);
+                const float top = collider.bounds.top - std::max(collider.displacement.y, 0.0f);
+                collider.bounds = {left, top, collider.bounds.width + std::abs(collider.displacement.x), collider.bounds.height + std::abs(collider.displacement.y)};
+            }
+            _colliders.push_back(collider);
+        }
+    }
+
+    bool interested(const Collider &a, const Collider &b) const
+    {
+        return (a.listens & b.mask) != 0 || (b.listens & a.mask) != 0;
+    }
+
+    void bruteForce()
+    {
+        for (uint32_t i = 0; i < _colliders.size(); ++i) {
+            for (uint32_t j = i + 1; j < _colliders.size(); ++j) {
+                ++_stats.pairsTested;
+                if (interested(_colliders[i], _colliders[j]) && _colliders[i].bounds.intersects(_colliders[j].bounds))
+                    _candidates.emplace_back(i, j);
+            }
+        }
+    }
+
+    void sweepAndPrune()
+    {
+        _order.resize(_colliders.size());
+        std::iota(_order.begin(), _order.end(), 0);
+        std::ranges::sort(_order, [&](const uint32_t a, const uint32_t b) {
+            return _colliders[a].bounds.left < _colliders[b].bounds.left;
+        });
+
+        for (size_t i = 0; i < _order.size(); ++i) {
+            const Collider &collider = _colliders[_order[i]];
+            const float right = collider.bounds.left + collider.bounds.width;
+            for (size_t j = i + 1; j < _order.size() && _colliders[_order[j]].bounds.left < right; ++j) {
+                const Collider &other = _colliders[_order[j]];
+                ++_stats.pairsTested;
+                if (!interested(collider, other))
+                    continue;
+                if (collider.bounds.top < other.bounds.top + other.bounds.height && other.bounds.top < collider.bounds.top + collider.bounds.height)
+                    _candidates.emplace_back(_order[i], _order[j]);
+            }
+        }
+    }
+
+    void narrowphase()
+    {
+        for (auto &buffer : _buffers)
+            buffer.clear();
+
+        const auto test = [&](const size_t worker, const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto &[a, b] = _candidates[i];
+                if (const auto time = timeOfImpact(_colliders[a], _colliders[b]))
+                    _buffers[worker].push_back({a, b, *time});
+            }
+        };
+
+        if (!_pool || _candidates.size() < MIN_PAIRS_PER_WORKER * _pool->size()) {
+            test(0, 0, _candidates.size());
+            return;
+        }
+        _pool->parallel_for(_candidates.size(), test);
+    }
+
+    Broadphase _broadphase = Broadphase::SweepAndPrune;
+    std::unique_ptr<WorkerPool> _pool;           ///< Narrowphase workers, null when running on the calling thread.
+    std::vector<Collider> _colliders;            ///< Colliders snapshotted for the current scan.
+    std::vector<uint32_t> _order;                ///< Collider indices sorted along the x axis.
+    std::vector<Pair> _candidates;               ///< Pairs kept by the broadphase.
+    std::vector<std::vector<Hit>> _buffers{1};   ///< Per-worker contact buffers.
+    ContactTracker _tracker;
+    CollisionStats _stats;
+};
+
+} // namespace core::ge
+
+#endif /* !COLLISION_HPP_ */
@@ -1,9 +1,10 @@
 #ifndef GAMEENGINE_HPP_
 #define GAMEENGINE_HPP_
 
-#include <SFML/Graphics/Color.hpp>
-#include <SFML/Graphics/Text.hpp>
 #include <cmath>
+#ifndef GE_HEADLESS
+    #include <SFML/Graphics/Color.hpp>
+    #include <SFML/Graphics/Text.hpp>
 extern "C"
 {
     #include <lua.h>
@@ -11,18 +12,22 @@ extern "C"
     #include <lualib.h>
 }
 
-#include <LuaBridge/LuaBridge.h>
+    #include <LuaBridge/LuaBridge.h>
+#endif
 
 #include "../Registry/Registry.hpp"
 #include "./GameEngineComponents.hpp"
-#include "MusicManager.hpp"
-#include "AssetManager.hpp"
-#ifdef GE_USE_SDL
-    #include <SDL.h>
+#include "./Collision.hpp"
+#ifndef GE_HEADLESS
+    #include "MusicManager.hpp"
+    #include "AssetManager.hpp"
+    #ifdef GE_USE_SDL
+        #include <SDL.h>
+    #endif
+    #include <SFML/Main.hpp>
+    #include <SFML/Window/WindowStyle.hpp>
 #endif
-#include <SFML/Main.hpp>
 #include <SFML/System/Clock.hpp>
-#include <SFML/Window/WindowStyle.hpp>
 
 #include "Shell.hpp"
 
@@ -33,6 +38,10 @@ namespace core {
  *
  * The `GameEngine` class is responsible for initializing and managing the game components, such as the entity registry, systems,
  * rendering, and sound. It also manages the SFML window and the scene switching logic.
+ *
+ * Defining `GE_HEADLESS` builds the engine for simulation only: the ECS, the math types and the movement,
+ * physics and collision systems. Rendering, input, sound, assets, metrics and Lua are compiled out, so a
+ * headless program needs neither a display nor the SFML graphics, window and audio libraries, nor Lua.
  */
 class GameEngine {
 public:
@@ -42,57 +51,77 @@ public:
      * The constructor initializes the component registry and sets up various game systems such as rendering, animations, and collisions.
      * Optionally, it can initialize an SFML window for rendering.
      *
-     * @param initWindow A boolean flag that indicates whether to initialize the SFML window. Default is true.
+     * @param initWindow A boolean flag that indicates whether to initialize the SFML window. Default is true. Ignored when headless.
+     * @param log A log stream shared with other engines of the process. When given, the engine writes to it and
+     * does not start its own shell; otherwise it owns a shell reading commands from stdin and logging to a file.
      */
-    GameEngine(bool initWindow = true)
+    GameEngine([[maybe_unused]] bool initWindow = true, std::ostream *log = nullptr)
+#ifndef GE_HEADLESS
         : luaState(nullptr),
           cpuEntity(ecs::Entity{}),
           ramEntity(ecs::Entity{}),
-          fpsEntity(ecs::Entity{}),
-          shell(registry) {
+          fpsEntity(ecs::Entity{})
+#endif
+    {
         // Register all necessary components
         registry.register_component<core::ge::TransformComponent>();
+        registry.register_component<core::ge::ClockComponent>();
+        registry.register_component<core::ge::VelocityComponent>();
+        registry.register_component<core::ge::CollisionComponent>();
+        registry.register_component<core::ge::ContinuousCollisionComponent>();
+        registry.register_component<core::ge::DisabledComponent>();
+        registry.register_component<core::ge::PhysicsComponent>();
+        registry.register_component<core::ge::GravityComponent>();
+#ifndef GE_HEADLESS
         registry.register_component<core::ge::DrawableComponent>();
         registry.register_component<core::ge::KeyBinding>();
-        registry.register_component<core::ge::ClockComponent>();
         registry.register_component<core::ge::AnimationComponent>();
         registry.register_component<core::ge::TextureComponent>();
         registry.register_component<core::ge::SoundComponent>();
         registry.register_component<core::ge::MusicComponent>();
         registry.register_component<core::ge::ClickableComponent>();
         registry.register_component<core::ge::ColorComponent>();
-        registry.register_component<core::ge::VelocityComponent>();
-        registry.register_component<core::ge::CollisionComponent>();
         registry.register_component<core::ge::TextComponent>();
         registry.register_component<core::ge::TextInputComponent>();
         registry.register_component<core::ge::SliderComponent>();
-        registry.register_component<core::ge::DisabledComponent>();
         registry.register_component<core::ge::MetricsComponent>();
-        registry.register_component<core::ge::PhysicsComponent>();
-        registry.register_component<core::ge::GravityComponent>();
+#endif
 
         // Initialize systems
+#ifndef GE_HEADLESS
         positionSystem();
         renderSystems();
         animationSystem();
         soundSystem();
+#endif
         velocitySystem();
         collisionSystem();
+#ifndef GE_HEADLESS
         clickableSystem();
         textSystem();
         textInputSystem();
         sliderSystem();
+#endif
         physicsSystem();
 
+#ifndef GE_HEADLESS
         luaState = luaL_newstate();
         luaL_openlibs(luaState);
+#endif
 
-        out = &shell.out();
+        if (log) {
+            out = log;
+        } else {
+            shell = std::make_unique<ge::Shell>(registry);
+            out = &shell->out();
+        }
 
+#ifndef GE_HEADLESS
         if (!initWindow)
             return;
 
         this->initWindow({800, 600}, 60, "Game");
+#endif
     }
 
     /**
@@ -100,9 +129,11 @@ public:
      */
     ~GameEngine()
     {
-        shell.close();
+        if (shell)
+            shell->close();
     }
 
+#ifndef GE_HEADLESS
     /**
      * @brief run a lua script openned by the path and call the function with the args
      *
@@ -128,6 +159,7 @@ public:
 
         return luaFunction(std::forward<Args>(args)...);
     }
+#endif
 
     /**
      * @brief Run the collision system for the given entity.
@@ -146,9 +178,36 @@ public:
         }
     }
 
-    std::ofstream *out;                 ///< The output stream for the shell.
+    /**
+     * @brief Kills an entity once the current collision dispatch is over.
+     *
+     * Collision callbacks should use this rather than `registry.kill_entity`, so the other
+     * callbacks of the same tick still see a coherent registry. The entity takes part in no
+     * further contact until it is removed.
+     *
+     * @param entity The entity to kill.
+     */
+    void defer_kill(const ecs::Entity entity)
+    {
+        if (std::ranges::find(pendingKills, entity) == pendingKills.end())
+            pendingKills.push_back(entity);
+    }
+
+    /**
+     * @brief Kills every entity queued with `defer_kill`.
+     */
+    void flush_kills()
+    {
+        for (const auto &entity : pendingKills)
+            registry.kill_entity(entity);
+        pendingKills.clear();
+    }
+
+    std::ostream *out;                  ///< The log stream, owned by the shell or shared with the other engines.
     float delta_t = 0.0f;               ///< Time delta between frames, used for animations and movement.
     core::ecs::Registry registry;       ///< The entity-component system (ECS) registry managing all entities and components.
+    ge::CollisionDetector collisionDetector; ///< Finds the contacts dispatched by the collision system.
+#ifndef GE_HEADLESS
     MusicManager musicManager;          ///< Manager for background music in the game.
     #ifdef GE_USE_SDL
         SDL_Window *sdlWindow;          ///< The SDL window where the game is drawn.
@@ -158,8 +217,10 @@ public:
         sf::RenderWindow window;            ///< The SFML render window where the game is drawn.
         AssetManager assetManager;          ///< Manager for game assets such as textures and sounds.
     #endif
+#endif
     int currentScene = 0;               ///< The currently active scene, represented by an integer.
     sf::Clock clock;                    ///< SFML clock for tracking time in the game loop.
+#ifndef GE_HEADLESS
     core::ge::KeyBinding keyBindingsConfig; ///< The key bindings configuration for the game.
     lua_State *luaState;                ///< The Lua state for running Lua scripts.
 
@@ -513,20 +574,25 @@ public:
     {
         initGameMetrics();
     }
+#endif
 
     /**
      * @brief Add a command to the shell.
      *
+     * Engines writing to a shared log have no shell of their own: the command is ignored.
+     *
      * @param command
      * @param description
      * @param callback
      */
     void addCommand(const std::string &command, const std::string &description, const std::function<std::string(std::string)> &callback)
     {
-        shell.addCommand(command, description, callback);
+        if (shell)
+            shell->addCommand(command, description, callback);
     }
 
 protected:
+#ifndef GE_HEADLESS
     /**
      * @brief Sets up the system for rendering drawable components.
      *
@@ -634,6 +700,8 @@ protected:
         });
     }
 
+#endif
+
     /**
      * @brief Sets up the velocity system for handling entity movement.
      *
@@ -650,56 +718,36 @@ protected:
     /**
      * @brief Sets up the collision detection system for handling interactions between entities.
      *
-     * This system checks for collisions between entities and triggers their `onCollision` callbacks if they intersect.
+     * The system first lets `collisionDetector` find the overlapping pairs and turn them into
+     * enter/stay/exit contacts. Callbacks are only dispatched after the scan, in order of time of impact:
+     * for each entering or staying contact the `onCollision` callbacks of both entities whose mask matches
+     * the other entity are called, and for each exiting one their `onSeparation` callbacks. Entities killed
+     * with `defer_kill` are removed once every contact has been dispatched.
      */
     void collisionSystem() {
-        registry.add_system<ge::TransformComponent, ge::CollisionComponent>(
-            [&](const ecs::Entity entity, const ge::TransformComponent &transform, ge::CollisionComponent &collision) {
-
-                auto &collisionComponents = registry.get_components<ge::CollisionComponent>();
-                auto &transformComponents = registry.get_components<ge::TransformComponent>();
-
-                for (size_t i = 0; i < collisionComponents.size(); ++i) {
-                    if (!collisionComponents[i].has_value() || !transformComponents[i].has_value())
-                        continue;
-
-                    ecs::Entity otherEntity{i};
-                    if (entity == otherEntity)
-                        continue;
-
-                    const auto &otherCollision = *collisionComponents[i];
-                    const auto &otherTransform = *transformComponents[i];
-
-                    for (const auto &box : collision.collisionBoxes) {
-                        sf::FloatRect rect = {
-                            box.left + transform.position.x,
-                            box.top + transform.position.y,
-                            box.width * transform.scale.x,
-                            box.height * transform.scale.y
-                        };
-
-                        for (const auto &otherBox : otherCollision->collisionBoxes) {
-                            sf::FloatRect otherRect = {
-                                otherBox.left + otherTransform->position.x,
-                                otherBox.top + otherTransform->position.y,
-                                otherBox.width * otherTransform->scale.x,
-                                otherBox.height * otherTransform->scale.y
-                            };
-
-                            if (!rect.intersects(otherRect))
-                                continue;
-
-                            for (auto &[mask, onCollision] : collision.onCollision) {
-                                if ((mask & otherCollision->collisionMask) == 0)
-                                    continue;
-                                onCollision(entity, otherEntity);
-                            }
-                        }
-                    }
-                }
-            });
+        registry.add_global_system<ge::TransformComponent, ge::CollisionComponent>([&](ecs::Registry &) {
+            auto &transforms = registry.get_components<ge::TransformComponent>();
+            auto &continuous = registry.get_components<ge::ContinuousCollisionComponent>();
+            const auto &contacts = collisionDetector.detect(registry.get_components<ge::CollisionComponent>(), transforms, continuous);
+
+            for (const auto &[first, second, state, timeOfImpact] : contacts) {
+                if (!is_collidable(first) || !is_collidable(second))
+                    continue;
+                dispatch_collision(first, second, state);
+                dispatch_collision(second, first, state);
+            }
+            flush_kills();
+
+            for (size_t i = 0; i < continuous.size(); ++i) {
+                if (!continuous[i].has_value() || !transforms[i].has_value())
+                    continue;
+                (*continuous[i])->previousPosition = (*transforms[i])->position;
+                (*continuous[i])->hasPreviousPosition = true;
+            }
+        });
     }
 
+#ifndef GE_HEADLESS
     /**
      * @brief Sets up the clicable interaction system.
      *
@@ -899,9 +947,39 @@ protected:
                 });
         #endif
     }
+#endif
     private:
-        ge::Shell shell; ///< The shell instance for the game.
+        std::unique_ptr<ge::Shell> shell; ///< The shell instance for the game, if the engine owns its log.
+        std::vector<ecs::Entity> pendingKills; ///< Entities to kill after the collision dispatch.
+
+        /**
+         * @brief Checks whether an entity can still receive collision callbacks this tick.
+         */
+        bool is_collidable(const ecs::Entity entity)
+        {
+            return registry.has_component<ge::CollisionComponent>(entity)
+                && std::ranges::find(pendingKills, entity) == pendingKills.end();
+        }
+
+        /**
+         * @brief Calls the callbacks of an entity matching the mask of the entity it collides with, or
+         * separates from on an exiting contact.
+         */
+        void dispatch_collision(const ecs::Entity entity, const ecs::Entity other, const ge::ContactState state)
+        {
+            // Hold the components: a callback may remove them while we iterate.
+            const auto collision = registry.get_component<ge::CollisionComponent>(entity);
+            const auto otherCollision = registry.get_component<ge::CollisionComponent>(other);
+
+            auto &callbacks = state == ge::ContactState::Exit ? collision->onSeparation : collision->onCollision;
+            for (auto &[mask, onCollision] : callbacks) {
+                if ((mask & otherCollision->collisionMask) == 0)
+                    continue;
+                onCollision(entity, other);
+            }
+        }
 
+#ifndef GE_HEADLESS
         /**
          * @brief Get the CPU usage in percentage.
          *
@@ -951,6 +1029,7 @@ protected:
                 return std::stof(result);
             #endif
         }
+#endif
         void physicsSystem() {
             registry.add_system<ge::TransformComponent, ge::VelocityComponent, ge::PhysicsComponent>(
                 [&]([[maybe_unused]] ecs::Entity entity, [[maybe_unused]] ge::TransformComponent &transform,
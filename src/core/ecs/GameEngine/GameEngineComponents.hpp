@@ -2,11 +2,17 @@
 #define GAMEENGINECOMPONENTS_HPP_
 
 #include <functional>
+#include <map>
 #include <memory>
+#include <vector>
 
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Vector2.hpp>
+#ifndef GE_HEADLESS
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include <SFML/System/Vector2.hpp>
+#endif
 #ifdef GE_USE_SDL
 #include <SDL.h>
 #include <SDL_image.h>
@@ -15,6 +21,7 @@
 #endif
 
 #include "../Entity/Entity.hpp"
+#include "./StaticColliders.hpp"
 
 namespace core::ge {
 
@@ -32,6 +39,7 @@ enum class AnimationState {
     Charging,
 };
 
+#ifndef GE_HEADLESS
 /**
  * @struct KeyBinding
  * @brief Stores the key bindings for player controls.
@@ -45,6 +53,7 @@ struct KeyBinding {
     sf::Keyboard::Key moveRightKey = sf::Keyboard::Right;
     sf::Keyboard::Key fireKey = sf::Keyboard::Space;
 };
+#endif
 
 /**
  * @struct InputStateComponent
@@ -60,6 +69,7 @@ struct InputStateComponent {
     bool fire = false;
 };
 
+#ifndef GE_HEADLESS
 /**
  * @struct DrawableComponent
  * @brief Contains the drawable shape for an entity.
@@ -76,6 +86,7 @@ struct DrawableComponent {
     SDL_Texture* texture = nullptr;
 #endif
 };
+#endif
 
 /**
  * @struct ClockComponent
@@ -101,6 +112,7 @@ struct TransformComponent {
     float rotation = 0.0f;
 };
 
+#ifndef GE_HEADLESS
 /**
  * @struct ClickableComponent
  * @brief Defines a clickable entity, including its clicked state and the action to perform when clicked.
@@ -169,6 +181,7 @@ struct MusicComponent {
 struct TextureComponent {
     std::shared_ptr<sf::Texture> texture;
 };
+#endif
 
 /**
 * @struct VelocityComponent
@@ -187,13 +200,30 @@ struct VelocityComponent {
  * @brief Manages collision data and responses for an entity.
  *
  * Contains collision masks and bounding boxes used for collision detection, as well as a list of functions to execute upon collision with specific entities.
+ * `onCollision` callbacks run every tick the entities overlap, `onSeparation` ones on the tick they stop overlapping.
  */
 struct CollisionComponent {
     uint32_t collisionMask;
     std::vector<sf::FloatRect> collisionBoxes;
     std::vector<std::pair<uint32_t, std::function<void(const ecs::Entity&, const ecs::Entity&)>>> onCollision = {};
+    std::shared_ptr<const StaticBVH> staticColliders = nullptr; ///< Replaces the boxes in narrowphase when set. Rects are relative to the entity position, unscaled.
+    std::vector<std::pair<uint32_t, std::function<void(const ecs::Entity&, const ecs::Entity&)>>> onSeparation = {};
 };
 
+/**
+ * @struct ContinuousCollisionComponent
+ * @brief Flags a fast-moving entity whose collisions are tested along its whole movement.
+ *
+ * The collision system sweeps the boxes of the entity from `previousPosition` to its current position, so it
+ * cannot tunnel through thin colliders when the tick rate is low. The previous position is recorded at the
+ * end of every collision pass.
+ */
+struct ContinuousCollisionComponent {
+    sf::Vector2f previousPosition = {0, 0};
+    bool hasPreviousPosition = false;
+};
+
+#ifndef GE_HEADLESS
 /**
  * @struct TextComponent
  * @brief Manages text rendering for an entity.
@@ -245,6 +275,7 @@ struct SliderComponent {
     sf::CircleShape handle;
     std::function<void(float)> onChange;
 };
+#endif
 
 
 /**
@@ -255,11 +286,13 @@ struct DisabledComponent {
     bool disabled = false;
 };
 
+#ifndef GE_HEADLESS
 /**
  * @struct MetricsComponent
  * @brief Component to display performance metrics.
  */
 struct MetricsComponent {}; // only an identifier
+#endif
 
 /**
  * @struct PhysicsComponent
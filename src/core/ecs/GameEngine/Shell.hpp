@@ -1,8 +1,14 @@
 #ifndef SHELL_HPP
 #define SHELL_HPP
 
-#include <thread>
+#include <atomic>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
 
 namespace core::ge {
     class Shell {
@@ -92,7 +98,8 @@ namespace core::ge {
                 std::string command;
                 while (_running) {
                     std::cout << "> ";
-                    std::getline(std::cin, command);
+                    if (!std::getline(std::cin, command))
+                        break;
 
                     std::erase(command, '\n');
                     if (command.empty())
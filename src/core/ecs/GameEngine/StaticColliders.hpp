@@ -0,0 +1,190 @@
+#ifndef STATICCOLLIDERS_HPP_
+#define STATICCOLLIDERS_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+namespace core::ge {
+
+/**
+ * @brief Greedily merges the solid cells of a grid into as few rectangles as possible.
+ *
+ * Cells are visited row by row. Each free solid cell starts a rectangle which is first grown to the
+ * right, then downwards as long as the whole span of the next row is solid and free.
+ *
+ * @param solid The grid, indexed as `solid[y][x]`. Every row must have the same width.
+ * @return The merged rectangles, in cell units.
+ */
+inline std::vector<sf::IntRect> mergeCells(const std::vector<std::vector<bool>> &solid)
+{
+    std::vector<sf::IntRect> rects;
+    if (solid.empty())
+        return rects;
+
+    const int height = static_cast<int>(solid.size());
+    const int width = static_cast<int>(solid.front().size());
+    std::vector used(height, std::vector(width, false));
+    const auto isFree = [&](const int x, const int y) { return solid[y][x] && !used[y][x]; };
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (!isFree(x, y))
+                continue;
+
+            int w = 1;
+            while (x + w < width && isFree(x + w, y))
+                ++w;
+
+            int h = 1;
+            while (y + h < height) {
+                bool fullRow = true;
+                for (int i = x; i < x + w && fullRow; ++i)
+                    fullRow = isFree(i, y + h);
+                if (!fullRow)
+                    break;
+                ++h;
+            }
+
+            for (int j = y; j < y + h; ++j)
+                std::fill_n(used[j].begin() + x, w, true);
+            rects.emplace_back(x, y, w, h);
+        }
+    }
+    return rects;
+}
+
+/**
+ * @class StaticBVH
+ * @brief Bounding volume hierarchy over colliders that never move.
+ *
+ * The tree is built once, by recursively splitting the rectangles at the median of the longest axis
+ * of their bounds, and only answers overlap queries afterwards.
+ */
+class StaticBVH {
+public:
+    /**
+     * @brief Builds the hierarchy.
+     *
+     * @param rects The rectangles to index.
+     */
+    explicit StaticBVH(std::vector<sf::FloatRect> rects) : _rects(std::move(rects))
+    {
+        if (_rects.empty())
+            return;
+        _nodes.reserve(2 * _rects.size() / LEAF_SIZE + 1);
+        _nodes.emplace_back();
+        build(0, 0, static_cast<uint32_t>(_rects.size()));
+    }
+
+    /**
+     * @brief Gets the bounds of every rectangle of the hierarchy.
+     */
+    [[nodiscard]] sf::FloatRect bounds() const { return _nodes.empty() ? sf::FloatRect{} : _nodes.front().bounds; }
+
+    /**
+     * @brief Gets the indexed rectangles, reordered by the build.
+     */
+    [[nodiscard]] const std::vector<sf::FloatRect> &rects() const { return _rects; }
+
+    /**
+     * @brief Calls `visitor` on every rectangle overlapping `area`, until it returns false.
+     *
+     * @param area The area to query.
+     * @param visitor Callable as `bool(const sf::FloatRect &)`.
+     */
+    template <typename Visitor>
+    void query(const sf::FloatRect &area, Visitor &&visitor) const
+    {
+        if (_nodes.empty())
+            return;
+
+        uint32_t stack[64];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node &node = _nodes[stack[--top]];
+            if (!node.bounds.intersects(area))
+                continue;
+
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    if (_rects[i].intersects(area) && !visitor(_rects[i]))
+                        return;
+                }
+                continue;
+            }
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+
+    /**
+     * @brief Checks whether any rectangle overlaps `area`.
+     */
+    [[nodiscard]] bool overlaps(const sf::FloatRect &area) const
+    {
+        bool found = false;
+        query(area, [&](const sf::FloatRect &) {
+            found = true;
+            return false;
+        });
+        return found;
+    }
+
+private:
+    static constexpr uint32_t LEAF_SIZE = 4;
+
+    /**
+     * @brief A node of the tree. Leaves hold `count` rectangles starting at `first`; inner nodes
+     * have a count of 0 and their children at `first` and `first + 1`.
+     */
+    struct Node {
+        sf::FloatRect bounds;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    static sf::FloatRect merge(const sf::FloatRect &a, const sf::FloatRect &b)
+    {
+        const float left = std::min(a.left, b.left);
+        const float top = std::min(a.top, b.top);
+        return {left, top, std::max(a.left + a.width, b.left + b.width) - left, std::max(a.top + a.height, b.top + b.height) - top};
+    }
+
+    void build(const uint32_t slot, const uint32_t begin, const uint32_t end)
+    {
+        Node node{_rects[begin], begin, end - begin};
+        for (uint32_t i = begin + 1; i < end; ++i)
+            node.bounds = merge(node.bounds, _rects[i]);
+
+        if (end - begin > LEAF_SIZE) {
+            const bool splitX = node.bounds.width >= node.bounds.height;
+            const uint32_t middle = begin + (end - begin) / 2;
+            std::nth_element(_rects.begin() + begin, _rects.begin() + middle, _rects.begin() + end,
+                [splitX](const sf::FloatRect &a, const sf::FloatRect &b) {
+                    return splitX ? a.left + a.width / 2 < b.left + b.width / 2 : a.top + a.height / 2 < b.top + b.height / 2;
+                });
+
+            // Children are allocated next to each other so the node only stores the first one.
+            const auto children = static_cast<uint32_t>(_nodes.size());
+            _nodes.emplace_back();
+            _nodes.emplace_back();
+            build(children, begin, middle);
+            build(children + 1, middle, end);
+            node.first = children;
+            node.count = 0;
+        }
+        _nodes[slot] = node;
+    }
+
+    std::vector<sf::FloatRect> _rects;
+    std::vector<Node> _nodes;
+};
+
+} // namespace core::ge
+
+#endif /* !STATICCOLLIDERS_HPP_ */
@@ -0,0 +1,133 @@
+#ifndef WORKERPOOL_HPP_
+#define WORKERPOOL_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core::ge {
+
+/**
+ * @class WorkerPool
+ * @brief A fixed set of threads running fork-join jobs.
+ *
+ * The calling thread takes part in every job as worker 0, so a pool of size 1 has no thread of its
+ * own and simply runs the job inline.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Creates the pool and starts its threads.
+     *
+     * @param workers The number of workers, including the calling thread.
+     */
+    explicit WorkerPool(const size_t workers)
+    {
+        for (size_t i = 1; i < workers; ++i)
+            _threads.emplace_back([this, i] { loop(i); });
+    }
+
+    /**
+     * @brief Stops and joins every thread of the pool.
+     */
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _wakeUp.notify_all();
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /**
+     * @brief Gets the number of workers, including the calling thread.
+     */
+    [[nodiscard]] size_t size() const { return _threads.size() + 1; }
+
+    /**
+     * @brief Runs a job on every worker and waits for all of them to finish.
+     *
+     * @param job The job, called with the index of the worker running it.
+     */
+    void run(const std::function<void(size_t)> &job)
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _job = &job;
+            _remaining = _threads.size();
+            ++_generation;
+        }
+        _wakeUp.notify_all();
+
+        job(0);
+
+        std::unique_lock lock(_mutex);
+        _done.wait(lock, [this] { return _remaining == 0; });
+        _job = nullptr;
+    }
+
+    /**
+     * @brief Splits `[0, count)` into one contiguous range per worker and runs them in parallel.
+     *
+     * Ranges are assigned in worker order, so concatenating per-worker results by worker index
+     * gives the same order as a sequential loop.
+     *
+     * @param count The number of items to process.
+     * @param job The job, called as `job(worker, begin, end)`.
+     */
+    void parallel_for(const size_t count, const std::function<void(size_t, size_t, size_t)> &job)
+    {
+        const size_t workers = size();
+        run([&](const size_t worker) {
+            const size_t begin = count * worker / workers;
+            const size_t end = count * (worker + 1) / workers;
+            if (begin < end)
+                job(worker, begin, end);
+        });
+    }
+
+private:
+    void loop(const size_t index)
+    {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)> *job;
+            {
+                std::unique_lock lock(_mutex);
+                _wakeUp.wait(lock, [&] { return _stopping || _generation != seen; });
+                if (_stopping)
+                    return;
+                seen = _generation;
+                job = _job;
+            }
+
+            (*job)(index);
+
+            {
+                std::lock_guard lock(_mutex);
+                if (--_remaining != 0)
+                    continue;
+            }
+            _done.notify_one();
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::condition_variable _done;
+    const std::function<void(size_t)> *_job = nullptr;
+    uint64_t _generation = 0;
+    size_t _remaining = 0;
+    bool _stopping = false;
+    std::vector<std::jthread> _threads; ///< Declared last so the threads join before the state they use is destroyed.
+};
+
+} // namespace core::ge
+
+#endif /* !WORKERPOOL_HPP_ */
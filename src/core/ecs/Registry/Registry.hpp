@@ -214,6 +214,22 @@ public:
         }, std::vector<std::type_index>{typeid(Components)...});
     }
 
+    /**
+     * @brief Adds a system that runs once per call instead of once per entity.
+     *
+     * The system receives the whole registry, which lets it look at several entities at once
+     * (e.g. pairs of colliders). It is keyed by the given component types, so `run_system`
+     * triggers it exactly like a per-entity system.
+     *
+     * @tparam Components The component types the system is keyed by.
+     * @tparam Function The type of the system function, callable as `void(Registry &)`.
+     * @param f The system function to add.
+     */
+    template <class... Components, typename Function>
+    void add_global_system(Function &&f) {
+        _systems.emplace_back(std::forward<Function>(f), std::vector<std::type_index>{typeid(Components)...});
+    }
+
     /**
      * @brief Runs all systems that have been added to the ECS.
      * 
@@ -0,0 +1,372 @@
+#ifndef CHANNEL_HPP_
+#define CHANNEL_HPP_
+
+/**
+ * @file Channel.hpp
+ * @brief Delivery guarantees of the messages exchanged with a peer, on top of GDTP datagrams.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief How the messages of a type are delivered.
+ */
+enum class Channel : uint8_t {
+    Unreliable,          ///< Sent once, may be lost, duplicated or reordered.
+    UnreliableSequenced, ///< Sent once, a message older than the last one delivered of its type is dropped.
+    ReliableOrdered,     ///< Sent until acknowledged, delivered exactly once and in order.
+};
+
+/**
+ * @class PeerChannels
+ * @brief State of the channels with one peer: sequence numbers, acknowledgements and retransmissions.
+ *
+ * Messages that need a channel travel in envelopes, the payload of a GDTP packet laid out as:
+ * - the session of the sender (2 bytes), drawn at random for each peer it talks to,
+ * - the session of the peer it acknowledges (2 bytes), 0 until it received a reliable message of it,
+ * - the last reliable sequence received in order (2 bytes), and a bitfield of the 32 sequences after
+ *   the next one (4 bytes): bit `i` set means `ack + 2 + i` was received and is buffered,
+ * - then, unless the envelope only carries acknowledgements, the channel (1 byte), the sequence
+ *   (2 bytes) and the type (1 byte) of the message; a reliable message adds the oldest sequence the
+ *   sender still waits an acknowledgement for (2 bytes), where a receiver that has just heard of the
+ *   sender starts delivering. The payload of the message follows.
+ *
+ * Every envelope sent to a peer acknowledges what was received from it, so that acknowledgements
+ * ride on the traffic that flows anyway. A new session of the peer, e.g. a restarted client,
+ * resets what was received from it. The instance is not thread-safe.
+ */
+class PeerChannels {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t ENVELOPE_HEADER_SIZE = 10; ///< Sessions and acknowledgements.
+    static constexpr std::size_t MESSAGE_HEADER_SIZE = 4;   ///< Channel, sequence and type of the message.
+    static constexpr std::size_t RELIABLE_HEADER_SIZE = 2;  ///< Oldest reliable sequence not acknowledged.
+    static constexpr uint16_t WINDOW = 256;                 ///< Reliable messages in flight, and buffered out of order.
+    static constexpr unsigned MAX_SENDS = 15;               ///< Sends of a reliable message before the peer is given up.
+    static constexpr Clock::duration INITIAL_RTO = std::chrono::milliseconds(200);
+    static constexpr Clock::duration MIN_RTO = std::chrono::milliseconds(50);
+    static constexpr Clock::duration MAX_RTO = std::chrono::seconds(2);
+    static constexpr Clock::duration ACK_DELAY = std::chrono::milliseconds(20); ///< Wait for traffic to carry an acknowledgement.
+
+    /**
+     * @param session Session of this side, not 0.
+     */
+    explicit PeerChannels(const uint16_t session) : _session(session) {}
+
+    /**
+     * @brief Messages delivered by `receive()`, to hand to the handlers in order.
+     *
+     * A message read from the envelope views it, and one released from the reorder buffer views its
+     * payload, moved to `released`: nothing is copied. The views stay valid as long as the envelope and
+     * this object, and do not depend on the PeerChannels any more.
+     */
+    struct Delivered {
+        std::vector<std::pair<uint8_t, std::span<const uint8_t>>> messages; ///< Type and payload of each message.
+        std::vector<std::vector<uint8_t>> released;                         ///< Payloads moved out of the reorder buffer.
+    };
+
+    /**
+     * @brief Wraps a message in an envelope.
+     *
+     * A reliable message is kept until it is acknowledged, and sent again by `update()`.
+     *
+     * @param packetId Id of the GDTP packet carrying the message, reused by its retransmissions if set.
+     * @return The envelope to send, or nothing if the window of reliable messages in flight is full:
+     *         `update()` then sends it once the peer acknowledged the older ones.
+     */
+    std::optional<std::vector<uint8_t>> wrap(
+        const Channel channel, const uint8_t messageType, const std::span<const uint8_t> payload,
+        const Clock::time_point now, const std::optional<uint64_t> packetId)
+    {
+        uint16_t sequence = 0;
+        if (channel == Channel::UnreliableSequenced)
+            sequence = _nextSequenced[messageType]++;
+        if (channel != Channel::ReliableOrdered)
+            return envelope(channel, sequence, messageType, payload);
+
+        sequence = _nextReliable++;
+        _outgoing.push_back({sequence, messageType, {payload.begin(), payload.end()}, packetId, now, 0});
+        if (!inWindow(_outgoing.back()))
+            return std::nullopt;
+        _outgoing.back().sends = 1;
+        return envelope(channel, sequence, messageType, payload);
+    }
+
+    /**
+     * @brief Whether an acknowledgement waits for a message to carry it.
+     */
+    [[nodiscard]] bool ackPending() const { return _ackPendingSince.has_value(); }
+
+    /**
+     * @brief Sends what is due: the reliable messages not acknowledged in time, those the window held
+     * back, and the acknowledgements that found no message to ride on.
+     *
+     * @param output Called with each envelope to send and the id of the packet to send it in, if it has one.
+     * @return false if a reliable message was sent `MAX_SENDS` times unacknowledged: the peer is unreachable.
+     */
+    template <typename Output>
+    bool update(const Clock::time_point now, Output &&output)
+    {
+        for (Outgoing &message : _outgoing) {
+            if (!inWindow(message))
+                break;
+            if (message.sends != 0 && now - message.sentAt < backoff(message.sends))
+                continue;
+            if (message.sends >= MAX_SENDS)
+                return false;
+            ++message.sends;
+            message.sentAt = now;
+            output(envelope(Channel::ReliableOrdered, message.sequence, message.messageType, message.payload), message.packetId);
+        }
+        if (_ackPendingSince && now - *_ackPendingSince >= ACK_DELAY)
+            output(envelope(), std::optional<uint64_t>());
+        return true;
+    }
+
+    /**
+     * @brief Reads an envelope received from the peer.
+     *
+     * @param delivered Receives the messages to hand to the handlers, in order.
+     * @return false if the envelope is malformed.
+     */
+    bool receive(const std::span<const uint8_t> data, const Clock::time_point now, Delivered &delivered)
+    {
+        if (data.size() < ENVELOPE_HEADER_SIZE)
+            return false;
+        const uint16_t session = read16(data, 0);
+        if (session == 0)
+            return false;
+        if (session != _peerSession)
+            resetReceived(session);
+        _lastReceived = now;
+        if (read16(data, 2) == _session)
+            acknowledge(read16(data, 4), read32(data, 6), now);
+        if (data.size() == ENVELOPE_HEADER_SIZE)
+            return true;
+        if (data.size() < ENVELOPE_HEADER_SIZE + MESSAGE_HEADER_SIZE)
+            return false;
+
+        const auto channel = static_cast<Channel>(data[ENVELOPE_HEADER_SIZE]);
+        const uint16_t sequence = read16(data, ENVELOPE_HEADER_SIZE + 1);
+        const uint8_t messageType = data[ENVELOPE_HEADER_SIZE + 3];
+        const std::span<const uint8_t> payload = data.subspan(ENVELOPE_HEADER_SIZE + MESSAGE_HEADER_SIZE);
+        switch (channel) {
+            case Channel::Unreliable:
+                delivered.messages.emplace_back(messageType, payload);
+                return true;
+            case Channel::UnreliableSequenced:
+                if (_sequencedSeen[messageType] && !isNewer(sequence, _lastSequenced[messageType]))
+                    return true;
+                _sequencedSeen[messageType] = true;
+                _lastSequenced[messageType] = sequence;
+                delivered.messages.emplace_back(messageType, payload);
+                return true;
+            case Channel::ReliableOrdered:
+                if (payload.size() < RELIABLE_HEADER_SIZE)
+                    return false;
+                receiveReliable(sequence, read16(payload, 0), messageType, payload.subspan(RELIABLE_HEADER_SIZE), now, delivered);
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Gets the smoothed round-trip time, once a reliable message was acknowledged.
+     */
+    [[nodiscard]] std::optional<Clock::duration> rtt() const { return _srtt; }
+
+    /**
+     * @brief Gets the time a reliable message waits for its acknowledgement before it is sent again.
+     */
+    [[nodiscard]] Clock::duration rto() const { return _rto; }
+
+    /**
+     * @brief Gets when the last envelope was received from the peer.
+     */
+    [[nodiscard]] Clock::time_point lastReceived() const { return _lastReceived; }
+
+    /**
+     * @brief Whether reliable messages wait for an acknowledgement.
+     */
+    [[nodiscard]] bool idle() const { return _outgoing.empty(); }
+
+private:
+    struct Outgoing {
+        uint16_t sequence;
+        uint8_t messageType;
+        std::vector<uint8_t> payload;
+        std::optional<uint64_t> packetId;
+        Clock::time_point sentAt;
+        unsigned sends;
+    };
+
+    struct Received {
+        uint8_t messageType;
+        std::vector<uint8_t> payload;
+    };
+
+    static bool isNewer(const uint16_t sequence, const uint16_t reference)
+    {
+        return static_cast<int16_t>(static_cast<uint16_t>(sequence - reference)) > 0;
+    }
+
+    static uint16_t read16(const std::span<const uint8_t> data, const std::size_t offset)
+    {
+        return static_cast<uint16_t>((data[offset] << 8) | data[offset + 1]);
+    }
+
+    static uint32_t read32(const std::span<const uint8_t> data, const std::size_t offset)
+    {
+        return (static_cast<uint32_t>(read16(data, offset)) << 16) | read16(data, offset + 2);
+    }
+
+    static void write16(std::vector<uint8_t> &data, const uint16_t value)
+    {
+        data.push_back(static_cast<uint8_t>(value >> 8));
+        data.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Only the oldest messages in flight are sent, so that the peer can buffer every one that arrives
+    bool inWindow(const Outgoing &message) const
+    {
+        return static_cast<uint16_t>(message.sequence - _outgoing.front().sequence) < WINDOW;
+    }
+
+    // Exponential backoff: each retransmission of a message waits twice as long as the previous one
+    Clock::duration backoff(const unsigned sends) const
+    {
+        return std::min(_rto * (1 << std::min(sends - 1, 5u)), MAX_RTO);
+    }
+
+    std::vector<uint8_t> envelope()
+    {
+        _ackPendingSince.reset();
+        std::vector<uint8_t> data;
+        data.reserve(ENVELOPE_HEADER_SIZE + MESSAGE_HEADER_SIZE);
+        write16(data, _session);
+        write16(data, _started ? _peerSession : 0);
+        const auto ack = static_cast<uint16_t>(_nextExpected - 1);
+        write16(data, ack);
+        uint32_t bits = 0;
+        for (uint16_t i = 0; i < 32; i++) {
+            if (_buffered[static_cast<uint16_t>(ack + 2 + i) % WINDOW])
+                bits |= 1u << i;
+        }
+        write16(data, static_cast<uint16_t>(bits >> 16));
+        write16(data, static_cast<uint16_t>(bits));
+        return data;
+    }
+
+    std::vector<uint8_t> envelope(const Channel channel, const uint16_t sequence, const uint8_t messageType, const std::span<const uint8_t> payload)
+    {
+        std::vector<uint8_t> data = envelope();
+        data.reserve(ENVELOPE_HEADER_SIZE + MESSAGE_HEADER_SIZE + RELIABLE_HEADER_SIZE + payload.size());
+        data.push_back(static_cast<uint8_t>(channel));
+        write16(data, sequence);
+        data.push_back(messageType);
+        if (channel == Channel::ReliableOrdered)
+            write16(data, _outgoing.front().sequence);
+        data.insert(data.end(), payload.begin(), payload.end());
+        return data;
+    }
+
+    void resetReceived(const uint16_t session)
+    {
+        _peerSession = session;
+        _started = false;
+        for (auto &message : _buffered)
+            message.reset();
+        _sequencedSeen = {};
+        _ackPendingSince.reset();
+    }
+
+    void acknowledge(const uint16_t ack, const uint32_t bits, const Clock::time_point now)
+    {
+        std::erase_if(_outgoing, [&](const Outgoing &message) {
+            if (message.sends == 0)
+                return false;
+            const auto offset = static_cast<uint16_t>(message.sequence - ack);
+            const bool acked = offset >= 0x8000 || offset == 0
+                || (offset >= 2 && offset < 34 && (bits & (1u << (offset - 2))));
+            // Karn's rule: the round trip of a retransmitted message is ambiguous
+            if (acked && message.sends == 1)
+                sampleRtt(now - message.sentAt);
+            return acked;
+        });
+    }
+
+    // RFC 6298 smoothed round-trip time and retransmission timeout
+    void sampleRtt(const Clock::duration sample)
+    {
+        if (!_srtt) {
+            _srtt = sample;
+            _rttvar = sample / 2;
+        } else {
+            const Clock::duration delta = *_srtt > sample ? *_srtt - sample : sample - *_srtt;
+            _rttvar = (_rttvar * 3 + delta) / 4;
+            _srtt = (*_srtt * 7 + sample) / 8;
+        }
+        _rto = std::clamp(*_srtt + _rttvar * 4, MIN_RTO, MAX_RTO);
+    }
+
+    void receiveReliable(const uint16_t sequence, const uint16_t oldest, const uint8_t messageType,
+        const std::span<const uint8_t> payload, const Clock::time_point now, Delivered &delivered)
+    {
+        // What the sender no longer waits for was delivered to a previous instance of this side, if any
+        if (!_started) {
+            _nextExpected = oldest;
+            _started = true;
+        }
+        // Duplicates are acknowledged again, the previous acknowledgement may have been lost
+        if (!_ackPendingSince)
+            _ackPendingSince = now;
+        const auto offset = static_cast<uint16_t>(sequence - _nextExpected);
+        if (offset >= WINDOW)
+            return;
+        if (offset != 0) {
+            auto &slot = _buffered[sequence % WINDOW];
+            if (!slot)
+                slot = Received{messageType, {payload.begin(), payload.end()}};
+            return;
+        }
+
+        delivered.messages.emplace_back(messageType, payload);
+        ++_nextExpected;
+        for (auto *next = &_buffered[_nextExpected % WINDOW]; *next; next = &_buffered[_nextExpected % WINDOW]) {
+            // Moving the payload keeps its storage, which the view points to
+            const std::span<const uint8_t> view = delivered.released.emplace_back(std::move((*next)->payload));
+            delivered.messages.emplace_back((*next)->messageType, view);
+            next->reset();
+            ++_nextExpected;
+        }
+    }
+
+    uint16_t _session;
+    uint16_t _peerSession = 0;
+    Clock::time_point _lastReceived = Clock::now();
+
+    uint16_t _nextReliable = 0;                       ///< Sequence of the next reliable message sent.
+    std::deque<Outgoing> _outgoing;                   ///< Reliable messages not acknowledged yet, oldest first.
+    std::array<uint16_t, 256> _nextSequenced{};       ///< Sequence of the next sequenced message sent, per type.
+    std::optional<Clock::duration> _srtt;
+    Clock::duration _rttvar{};
+    Clock::duration _rto = INITIAL_RTO;
+
+    bool _started = false;                            ///< Whether a reliable message of the peer's session was received.
+    uint16_t _nextExpected = 0;                       ///< Sequence of the next reliable message delivered.
+    std::array<std::optional<Received>, WINDOW> _buffered; ///< Reliable messages received ahead of it.
+    std::array<uint16_t, 256> _lastSequenced{};       ///< Sequence of the last sequenced message delivered, per type.
+    std::array<bool, 256> _sequencedSeen{};
+    std::optional<Clock::time_point> _ackPendingSince; ///< When a reliable message was received and not acknowledged yet.
+};
+
+#endif // CHANNEL_HPP_
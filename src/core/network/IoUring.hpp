@@ -0,0 +1,311 @@
+#ifndef IOURING_HPP_
+#define IOURING_HPP_
+
+/**
+ * @file IoUring.hpp
+ * @brief Minimal io_uring bindings used by the io_uring transport of NetworkingService.
+ *
+ * The rings are driven with the raw system calls, the project does not depend on liburing.
+ * `NETWORK_HAS_IO_URING` is defined when the kernel headers know multishot receives.
+ */
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #if defined(IORING_RECV_MULTISHOT)
+        #define NETWORK_HAS_IO_URING
+    #endif
+#endif
+
+#ifdef NETWORK_HAS_IO_URING
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @class IoUring
+ * @brief An io_uring instance: a submission queue to fill and a completion queue to drain.
+ *
+ * Entries are prepared with `getSqe()`, handed to the kernel with `submit()`, and their results are read
+ * with `drain()`. An instance is not thread-safe: one thread at a time submits and drains.
+ */
+class IoUring {
+public:
+    /**
+     * @brief Creates the ring and maps its queues.
+     *
+     * @param entries Size of the submission queue.
+     * @param completionEntries Size of the completion queue, twice the submission queue if 0. Multishot
+     *                          requests post many completions per submission and need a larger one.
+     * @throws std::system_error If the kernel has no io_uring, or an io_uring without the features used here.
+     */
+    explicit IoUring(const unsigned entries, const unsigned completionEntries = 0)
+    {
+        io_uring_params params{};
+        if (completionEntries != 0) {
+            params.flags |= IORING_SETUP_CQSIZE;
+            params.cq_entries = completionEntries;
+        }
+        _fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (_fd < 0)
+            throw std::system_error(errno, std::system_category(), "io_uring_setup");
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+            release();
+            throw std::system_error(ENOSYS, std::system_category(), "io_uring_setup");
+        }
+
+        _ringSize = std::max(
+            params.sq_off.array + params.sq_entries * sizeof(unsigned),
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        _ring = mmap(nullptr, _ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+        if (_ring == MAP_FAILED) {
+            const int error = errno;
+            _ring = nullptr;
+            release();
+            throw std::system_error(error, std::system_category(), "io_uring mmap");
+        }
+        _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            const int error = errno;
+            release();
+            throw std::system_error(error, std::system_category(), "io_uring mmap");
+        }
+        _sqes = static_cast<io_uring_sqe *>(sqes);
+
+        auto *ring = static_cast<uint8_t *>(_ring);
+        _sqHead = reinterpret_cast<unsigned *>(ring + params.sq_off.head);
+        _sqTail = reinterpret_cast<unsigned *>(ring + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<unsigned *>(ring + params.sq_off.ring_mask);
+        _sqArray = reinterpret_cast<unsigned *>(ring + params.sq_off.array);
+        _sqEntries = params.sq_entries;
+        _cqHead = reinterpret_cast<unsigned *>(ring + params.cq_off.head);
+        _cqTail = reinterpret_cast<unsigned *>(ring + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<unsigned *>(ring + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe *>(ring + params.cq_off.cqes);
+        _localTail = *_sqTail;
+        _submitted = _localTail;
+    }
+
+    ~IoUring()
+    {
+        release();
+    }
+
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+
+    /**
+     * @brief Gets the file descriptor of the ring.
+     */
+    [[nodiscard]] int fd() const { return _fd; }
+
+    /**
+     * @brief Takes the next free submission queue entry, zeroed.
+     * @return The entry to fill, or nullptr if the submission queue is full.
+     */
+    io_uring_sqe *getSqe()
+    {
+        const unsigned head = std::atomic_ref(*_sqHead).load(std::memory_order_acquire);
+        if (_localTail - head >= _sqEntries)
+            return nullptr;
+
+        const unsigned index = _localTail & _sqMask;
+        _sqArray[index] = index;
+        ++_localTail;
+        std::memset(&_sqes[index], 0, sizeof(io_uring_sqe));
+        return &_sqes[index];
+    }
+
+    /**
+     * @brief Submits the prepared entries and optionally waits for completions.
+     *
+     * @param waitFor Number of completions to wait for, 0 to only submit.
+     * @param timeout Longest wait, so that the caller can regularly check whether it should stop.
+     * @throws std::system_error If the kernel rejects the call for another reason than an interruption,
+     *         a timeout or a full completion queue.
+     */
+    void submit(const unsigned waitFor = 0, const std::chrono::nanoseconds timeout = std::chrono::milliseconds(100))
+    {
+        std::atomic_ref(*_sqTail).store(_localTail, std::memory_order_release);
+
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        __kernel_timespec ts{seconds.count(), (timeout - seconds).count()};
+        io_uring_getevents_arg arg{};
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        const unsigned flags = IORING_ENTER_EXT_ARG | (waitFor != 0 ? IORING_ENTER_GETEVENTS : 0);
+
+        const long result = syscall(__NR_io_uring_enter, _fd, _localTail - _submitted, waitFor, flags, &arg, sizeof(arg));
+        if (result >= 0) {
+            _submitted += static_cast<unsigned>(result);
+            return;
+        }
+        if (errno != EINTR && errno != ETIME && errno != EBUSY && errno != EAGAIN)
+            throw std::system_error(errno, std::system_category(), "io_uring_enter");
+    }
+
+    /**
+     * @brief Calls @p handler with every completion posted since the last call, then releases them.
+     * @return The number of completions handled.
+     */
+    template <typename Handler>
+    unsigned drain(Handler &&handler)
+    {
+        unsigned head = *_cqHead;
+        const unsigned tail = std::atomic_ref(*_cqTail).load(std::memory_order_acquire);
+        const unsigned count = tail - head;
+
+        for (; head != tail; ++head)
+            handler(_cqes[head & _cqMask]);
+        std::atomic_ref(*_cqHead).store(head, std::memory_order_release);
+        return count;
+    }
+
+private:
+    void release()
+    {
+        if (_sqes)
+            munmap(_sqes, _sqesSize);
+        if (_ring)
+            munmap(_ring, _ringSize);
+        if (_fd >= 0)
+            close(_fd);
+        _sqes = nullptr;
+        _ring = nullptr;
+        _fd = -1;
+    }
+
+    int _fd = -1;
+    void *_ring = nullptr;
+    size_t _ringSize = 0;
+    io_uring_sqe *_sqes = nullptr;
+    size_t _sqesSize = 0;
+
+    unsigned *_sqHead = nullptr;
+    unsigned *_sqTail = nullptr;
+    unsigned *_sqArray = nullptr;
+    unsigned _sqMask = 0;
+    unsigned _sqEntries = 0;
+    unsigned _localTail = 0;  ///< Tail including the entries prepared but not published yet.
+    unsigned _submitted = 0;  ///< Tail up to which the kernel consumed the entries.
+
+    unsigned *_cqHead = nullptr;
+    unsigned *_cqTail = nullptr;
+    unsigned _cqMask = 0;
+    io_uring_cqe *_cqes = nullptr;
+};
+
+/**
+ * @class IoUringBufferRing
+ * @brief Buffers registered with a ring, which the kernel picks from to complete receives.
+ *
+ * A multishot receive fills one of these buffers per datagram: the completion carries the id of the
+ * buffer, which must be given back with `recycle()` once the datagram is handled.
+ */
+class IoUringBufferRing {
+public:
+    /**
+     * @brief Allocates the buffers and registers them with the ring.
+     *
+     * @param ring The ring the receives are submitted to; it must outlive the buffers.
+     * @param group Id of the buffer group, passed in the receive requests.
+     * @param count Number of buffers, a power of two.
+     * @param size Size of each buffer.
+     * @throws std::system_error If the kernel does not support provided buffer rings.
+     */
+    IoUringBufferRing(IoUring &ring, const uint16_t group, const unsigned count, const size_t size)
+        : _ring(ring), _group(group), _count(count), _size(size), _buffers(count * size)
+    {
+        _entriesSize = count * sizeof(io_uring_buf);
+        void *entries = mmap(nullptr, _entriesSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (entries == MAP_FAILED)
+            throw std::system_error(errno, std::system_category(), "io_uring buffer ring mmap");
+        _entries = static_cast<io_uring_buf *>(entries);
+
+        io_uring_buf_reg registration{};
+        registration.ring_addr = reinterpret_cast<uint64_t>(_entries);
+        registration.ring_entries = count;
+        registration.bgid = group;
+        if (syscall(__NR_io_uring_register, _ring.fd(), IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+            const int error = errno;
+            munmap(_entries, _entriesSize);
+            throw std::system_error(error, std::system_category(), "io_uring_register");
+        }
+
+        for (unsigned id = 0; id < count; ++id)
+            add(static_cast<uint16_t>(id));
+        publish();
+    }
+
+    ~IoUringBufferRing()
+    {
+        io_uring_buf_reg registration{};
+        registration.bgid = _group;
+        syscall(__NR_io_uring_register, _ring.fd(), IORING_UNREGISTER_PBUF_RING, &registration, 1);
+        munmap(_entries, _entriesSize);
+    }
+
+    IoUringBufferRing(const IoUringBufferRing &) = delete;
+    IoUringBufferRing &operator=(const IoUringBufferRing &) = delete;
+
+    [[nodiscard]] uint16_t group() const { return _group; }
+
+    /**
+     * @brief Gets the buffer of an id, as given by a completion.
+     */
+    [[nodiscard]] std::span<uint8_t> buffer(const uint16_t id)
+    {
+        return {_buffers.data() + id * _size, _size};
+    }
+
+    /**
+     * @brief Hands a buffer back to the kernel, for a next receive.
+     */
+    void recycle(const uint16_t id)
+    {
+        add(id);
+        publish();
+    }
+
+private:
+    void add(const uint16_t id)
+    {
+        io_uring_buf &entry = _entries[(_tail + _pending) & (_count - 1)];
+        entry.addr = reinterpret_cast<uint64_t>(_buffers.data() + id * _size);
+        entry.len = static_cast<uint32_t>(_size);
+        entry.bid = id;
+        ++_pending;
+    }
+
+    void publish()
+    {
+        _tail = static_cast<uint16_t>(_tail + _pending);
+        _pending = 0;
+        // The tail overlays the reserved field of the first entry
+        std::atomic_ref(_entries[0].resv).store(_tail, std::memory_order_release);
+    }
+
+    IoUring &_ring;
+    uint16_t _group;
+    unsigned _count;
+    size_t _size;
+    std::vector<uint8_t> _buffers;
+    io_uring_buf *_entries = nullptr; ///< Not an io_uring_buf_ring: its flexible array is laid out differently in C++.
+    size_t _entriesSize = 0;
+    uint16_t _tail = 0;
+    uint16_t _pending = 0;
+};
+
+#endif // NETWORK_HAS_IO_URING
+
+#endif // IOURING_HPP_
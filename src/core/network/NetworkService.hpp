@@ -5,16 +5,54 @@
  * @file NetworkingService.hpp
  * @brief Defines the NetworkingService class, which provides UDP-based networking functionality.
  */
+    #include <algorithm>
     #include <asio.hpp>
+    #include <atomic>
     #include <chrono>
     #include <cstdint> // Pour les types uint8_t, uint16_t, uint64_t
     #include <cstring>
     #include <iostream>
+    #include <map>
+    #include <random>
     #include <string>
     #include <thread>
+    #include <type_traits>
     #include <vector>
-    #include <map>
+    #include <array>
+    #include <memory>
+    #include <span>
+    #include <optional>
+    #include <mutex>
     #include "./includes/RequestHeader.hpp"
+    #include "./Channel.hpp"
+    #include "./IoUring.hpp"
+    #include "./Reassembler.hpp"
+    #ifdef __linux__
+        #include <cerrno>
+        #include <sys/socket.h>
+    #endif
+
+/**
+ * @struct OutboundPacket
+ * @brief A packet waiting to be sent, for the senders that queue their traffic and flush it at once.
+ *
+ * @see NetworkingService::sendPackets()
+ */
+struct OutboundPacket {
+    asio::ip::udp::endpoint endpoint;     ///< Recipient of the packet.
+    std::optional<GDTPHeader> response;   ///< Header of the request answered, if the packet is a response.
+    uint8_t messageType = 0;              ///< Type of the message, unless the packet is a response.
+    std::vector<uint8_t> payload;         ///< Payload of the message.
+};
+
+/**
+ * @struct FramedMessage
+ * @brief A message wrapped for the channel of its type, as returned by NetworkingService::frame().
+ */
+struct FramedMessage {
+    uint8_t messageType;          ///< Type of the message, or `NetworkingService::ENVELOPE_MESSAGE` if it was wrapped.
+    std::vector<uint8_t> payload; ///< Payload of the message, or the envelope carrying it.
+};
 
 /**
  * @class NetworkingService
@@ -26,6 +64,37 @@
  */
 class NetworkingService {
 public:
+    /**
+     * @brief Function called with every received message of a type.
+     *
+     * The payload is a view into the receive buffer, valid only for the duration of the call:
+     * a handler that keeps the data must copy it.
+     */
+    using MessageHandler = std::function<void(const GDTPHeader&, std::span<const uint8_t>, const asio::ip::udp::endpoint&)>;
+
+    /**
+     * @brief Tag of a message type, selecting the overload of a handler set with `setStaticHandlers()`.
+     */
+    template <uint8_t MessageType>
+    using Message = std::integral_constant<uint8_t, MessageType>;
+
+    static constexpr std::size_t IO_BATCH_SIZE = 32; ///< Datagrams received or sent per system call in batched I/O mode.
+    static constexpr unsigned IO_URING_RECV_BUFFERS = 256; ///< Receive buffers registered with the io_uring transport.
+    static constexpr std::size_t RECV_BUFFER_SIZE = 1400; ///< Largest datagram received, header included.
+    static constexpr std::size_t FRAGMENT_SIZE = RECV_BUFFER_SIZE - HEADER_SIZE; ///< Payload of each fragment of a larger message.
+    static constexpr std::size_t MAX_MESSAGE_SIZE = Reassembler::MAX_SIZE; ///< Largest payload sent, fragmented if needed.
+    static constexpr uint8_t ENVELOPE_MESSAGE = 0xFF; ///< Message type reserved for the envelopes of the channels.
+    static constexpr std::chrono::seconds PEER_TIMEOUT{60}; ///< Silence after which the channels with a peer are dropped.
+    static constexpr std::size_t MAX_PEERS = 1024; ///< Peers whose envelopes are opened, those of new peers are dropped beyond it.
+
+    /**
+     * @brief Backend moving the datagrams between the socket and the handlers.
+     */
+    enum class Transport {
+        Asio,    ///< ASIO asynchronous receive, optionally batched with recvmmsg/sendmmsg on Linux.
+        IoUring, ///< io_uring multishot receive into registered buffers, Linux 6.0 or later.
+    };
+
     /**
      * @brief Returns the singleton instance of NetworkingService.
      *
@@ -65,7 +134,8 @@ public:
     NetworkingService(
         const int port
     ) : _port(port){
-        message_handlers = std::make_shared<std::map<uint8_t, std::function<void(const GDTPHeader&, const std::vector<uint8_t>&, const asio::ip::udp::endpoint&)>>>();
+        message_handlers = std::make_shared<HandlerTable>();
+        peers_ = std::make_unique<Peers>();
     }
 
     /**
@@ -78,21 +148,189 @@ public:
      * @param messageType The GDTP message type for which the handler is being set.
      * @param handler The function that will process the message. The handler function takes three arguments:
      * - `const GDTPHeader& header`: The header of the received message.
-     * - `const std::vector<uint8_t>& payload`: The payload of the received message.
+     * - `std::span<const uint8_t> payload`: The payload of the received message, only valid during the call.
      * - `const asio::ip::udp::endpoint& client_endpoint`: The endpoint of the client that sent the message.
      *
      * @code
      * // Example usage:
-     * networkService.setMessageHandler(uint8_t::PlayerMovement, [](const GDTPHeader& header, const std::vector<uint8_t>& payload, const asio::ip::udp::endpoint& client_endpoint) {
+     * networkService.setMessageHandler(uint8_t::PlayerMovement, [](const GDTPHeader& header, std::span<const uint8_t> payload, const asio::ip::udp::endpoint& client_endpoint) {
      *     // Handle PlayerMovement message
      *     std::cout << "Received PlayerMovement message" << std::endl;
      * });
      * @endcode
      */
     void addEvent(const uint8_t messageType,
-        const std::function<void(const GDTPHeader&, const std::vector<uint8_t>&, const asio::ip::udp::endpoint&)>& handler) const
+        const MessageHandler& handler) const
     {
-        (*message_handlers)[messageType] = handler;
+        message_handlers->handlers[messageType] = handler;
+    }
+
+    /**
+     * @brief Sets the handlers of a fixed set of message types, dispatched at compile time.
+     *
+     * The dispatch over @p MessageTypes is generated from the template arguments, and calls the
+     * overloads of @p handler directly: they are not wrapped in a `std::function` each and can be
+     * inlined in it. Messages of these types take precedence over the handlers set with `addEvent()`,
+     * which still handle every other type.
+     *
+     * @tparam MessageTypes The message types @p handler handles.
+     * @param handler An object with an overload of `operator()(Message<Type>, const GDTPHeader&,
+     *                std::span<const uint8_t>, const asio::ip::udp::endpoint&)` for each type.
+     *
+     * @code
+     * // Example usage:
+     * struct Handlers {
+     *     void operator()(NetworkingService::Message<PlayerConnect>, const GDTPHeader&, std::span<const uint8_t>, const asio::ip::udp::endpoint&);
+     *     void operator()(NetworkingService::Message<PlayerInput>, const GDTPHeader&, std::span<const uint8_t>, const asio::ip::udp::endpoint&);
+     * };
+     * networkService.setStaticHandlers<PlayerConnect, PlayerInput>(Handlers{});
+     * @endcode
+     *
+     * @note Call it before `run()`, like `addEvent()`.
+     */
+    template <uint8_t... MessageTypes, typename Handler>
+    void setStaticHandlers(Handler handler) const
+    {
+        message_handlers->staticHandler = std::make_shared<Handler>(std::move(handler));
+        message_handlers->staticDispatch = &dispatchStatic<Handler, MessageTypes...>;
+    }
+
+    /**
+     * @brief Sets the channel the messages of a type are sent on, `Channel::Unreliable` by default.
+     *
+     * Sequenced and reliable messages travel in envelopes of type `ENVELOPE_MESSAGE`, which the receiving
+     * service opens before calling the handlers of the messages they carry: handlers never see envelopes.
+     * Reliable messages are retransmitted by `update()` until the peer acknowledges them, so it must be
+     * called regularly. See PeerChannels for the guarantees of each channel and the layout of an envelope.
+     *
+     * Unreliable messages are sent bare, unless an acknowledgement waits for the recipient: the next
+     * message to it then carries it in an envelope, to spare a datagram.
+     *
+     * @param messageType The message type.
+     * @param channel The channel its messages are sent on.
+     *
+     * @note Call it before `run()`, like `addEvent()`.
+     */
+    void setChannel(const uint8_t messageType, const Channel channel) const
+    {
+        message_handlers->channels[messageType] = channel;
+    }
+
+    /**
+     * @brief Wraps a message for the channel of its type, for the senders that queue their traffic.
+     *
+     * `sendRequest()` and `sendRequestResponse()` frame their messages themselves, `sendPackets()` sends
+     * the packets as they are: queued messages are framed with this function when they are queued.
+     *
+     * @param recipient The peer the message is for.
+     * @param messageType The type of the message.
+     * @param payload The payload of the message.
+     * @param packetId Id of the packet the message is sent in, reused by its retransmissions; a fresh one
+     *                 if not set. Responses must keep the id of the request.
+     * @return The message to send, or nothing if too many reliable messages to the recipient wait for an
+     *         acknowledgement: `update()` sends it once the older ones are acknowledged.
+     */
+    std::optional<FramedMessage> frame(
+        const asio::ip::udp::endpoint& recipient,
+        const uint8_t messageType,
+        std::vector<uint8_t> payload,
+        const std::optional<uint64_t> packetId = std::nullopt
+    ) const {
+        const Channel channel = message_handlers->channels[messageType];
+        if (!needsFraming(channel)) {
+            return FramedMessage{messageType, std::move(payload)};
+        }
+
+        std::lock_guard lock(peers_->mutex);
+        auto it = peers_->channels.find(recipient);
+        // An acknowledgement only rides on a message that still fits a datagram once wrapped
+        if (channel == Channel::Unreliable && (it == peers_->channels.end() || !it->second.ackPending()
+            || HEADER_SIZE + PeerChannels::ENVELOPE_HEADER_SIZE + PeerChannels::MESSAGE_HEADER_SIZE + payload.size() > RECV_BUFFER_SIZE)) {
+            return FramedMessage{messageType, std::move(payload)};
+        }
+        if (it == peers_->channels.end()) {
+            it = peers_->channels.emplace(recipient, PeerChannels(newSession())).first;
+        }
+
+        PeerChannels& peer = it->second;
+        const bool wasPending = peer.ackPending();
+        std::optional<std::vector<uint8_t>> envelope = peer.wrap(channel, messageType, payload, PeerChannels::Clock::now(), packetId);
+        countAck(wasPending, peer.ackPending());
+        if (!envelope) {
+            return std::nullopt;
+        }
+        return FramedMessage{ENVELOPE_MESSAGE, std::move(*envelope)};
+    }
+
+    /**
+     * @brief Sends what the channels have due: reliable messages not acknowledged in time and
+     * acknowledgements that found no message to ride on.
+     *
+     * Call it regularly, e.g. once per frame or tick: retransmissions are only as precise as its period.
+     * A peer that never acknowledges a reliable message after `PeerChannels::MAX_SENDS` sends, or that is
+     * silent for `PEER_TIMEOUT` with nothing to acknowledge, is forgotten.
+     */
+    void update() {
+        struct Due {
+            asio::ip::udp::endpoint recipient;
+            std::vector<uint8_t> envelope;
+            std::optional<uint64_t> packetId;
+        };
+        std::vector<Due> due;
+        const auto now = PeerChannels::Clock::now();
+        {
+            std::lock_guard lock(peers_->mutex);
+            for (auto it = peers_->channels.begin(); it != peers_->channels.end();) {
+                PeerChannels& peer = it->second;
+                const bool wasPending = peer.ackPending();
+                const bool reachable = peer.update(now, [&](std::vector<uint8_t> envelope, const std::optional<uint64_t> packetId) {
+                    due.push_back({it->first, std::move(envelope), packetId});
+                });
+                if (!reachable) {
+                    std::cerr << "Peer " << it->first << " does not acknowledge its messages, dropping its channels" << std::endl;
+                }
+                if (!reachable || (peer.idle() && now - peer.lastReceived() > PEER_TIMEOUT)) {
+                    countAck(wasPending, false);
+                    it = peers_->channels.erase(it);
+                    continue;
+                }
+                countAck(wasPending, peer.ackPending());
+                ++it;
+            }
+        }
+
+        for (const auto& [recipient, envelope, packetId] : due) {
+            sendPacket(requestHeader(ENVELOPE_MESSAGE, envelope.size(), packetId), envelope, recipient);
+        }
+    }
+
+    /**
+     * @brief Drops the channels with a peer, e.g. once it disconnected.
+     *
+     * Its reliable messages not acknowledged yet are dropped. If the peer talks again, new channels are
+     * opened, under a new session.
+     */
+    void forgetPeer(const asio::ip::udp::endpoint& peer) const {
+        std::lock_guard lock(peers_->mutex);
+        const auto it = peers_->channels.find(peer);
+        if (it == peers_->channels.end()) {
+            return;
+        }
+        countAck(it->second.ackPending(), false);
+        peers_->channels.erase(it);
+    }
+
+    /**
+     * @brief Hands a message to its handler, as if it had been received in its own packet.
+     *
+     * For handlers that unpack messages nested in their payload: envelopes among them are opened here.
+     */
+    void dispatch(
+        const GDTPHeader& header,
+        const std::span<const uint8_t> payload,
+        const asio::ip::udp::endpoint& client_endpoint
+    ) const {
+        processMessage(header.messageType, payload, header, client_endpoint);
     }
 
     /**
@@ -100,10 +338,7 @@ public:
      * @return A string representing the IP address and port in the format "IP:Port".
      */
     [[nodiscard]] std::string getLocalEndpoint() const {
-        if (!socket_.has_value()) {
-            throw std::runtime_error("Socket is not initialized");
-        }
-        asio::ip::udp::endpoint local_endpoint = socket_->local_endpoint();
+        asio::ip::udp::endpoint local_endpoint = primarySocket().local_endpoint();
         return local_endpoint.address().to_string() + ":" + std::to_string(local_endpoint.port());
     }
 
@@ -112,10 +347,7 @@ public:
      * @return A string representing the IP address.
      */
     [[nodiscard]] std::string getIp() const {
-        if (!socket_.has_value()) {
-            throw std::runtime_error("Socket is not initialized");
-        }
-        const asio::ip::udp::endpoint local_endpoint = socket_->local_endpoint();
+        const asio::ip::udp::endpoint local_endpoint = primarySocket().local_endpoint();
         return local_endpoint.address().to_string();
     }
 
@@ -124,32 +356,37 @@ public:
      * @return unsigned short representing the port number.
      */
     [[nodiscard]] uint32_t getPort() const {
-        if (!socket_.has_value()) {
-            throw std::runtime_error("Socket is not initialized");
-        }
-        return socket_->local_endpoint().port();
+        return primarySocket().local_endpoint().port();
     }
 
     /**
-    * @brief Destructor for NetworkingService. Closes the socket and stops the service.
+    * @brief Destructor for NetworkingService. Stops the service and closes the sockets.
+    *
+    * The network threads are joined before the sockets, receive buffers and rings they use are closed and destroyed.
     */
     ~NetworkingService() {
-        if (socket_.has_value()) {
-            socket_->close();
-        }
         stop();
+        attempt();
+        for (const auto& shard : shards_) {
+            shard->socket->close();
+        }
     }
 
     /**
      * @brief Sends a UDP request to the specified recipient with the given message type and payload.
      *
      * This function constructs a GDTP packet, consisting of a header and an optional payload, and sends it
-     * to the specified recipient's IP address and port. The header contains metadata such as the protocol version,
+     * to the specified recipient's endpoint. The header contains metadata such as the protocol version,
      * message type, packet ID, payload size, and information on packet sequencing. The payload represents the
      * data to be sent, such as game state updates or player actions.
      *
-     * @param recipient The IP address of the recipient to which the packet will be sent.
-     * @param port The port number on the recipient's side where the packet will be sent.
+     * This is the send path to use for repeated traffic: the recipient is already resolved, so no address
+     * is parsed, and the packet is built in a buffer reused by every send of the calling thread.
+     *
+     * The message is sent on the channel of its type, see `setChannel()`: if it is wrapped in an envelope,
+     * the envelope is sent in a packet with the same id as the returned header.
+     *
+     * @param recipient The UDP endpoint of the recipient, which includes the IP address and port.
      * @param messageType The type of the GDTP message to be sent, represented as a `uint8_t`.
      *                    The message type indicates what kind of data the packet contains (e.g., PlayerMovement, PingRequest).
      * @param payload A vector of bytes (`std::vector<uint8_t>`) representing the payload data to be sent with the message.
@@ -163,42 +400,54 @@ public:
      * - Sequence Number (2 bytes), defaults to 1 (for unfragmented packets).
      * - Total Packets (2 bytes), defaults to 1 (for unfragmented packets).
      *
-     * @note The `messageType` indicates the nature of the message being sent (e.g., Player Movement, Chat, etc.),
-     * and the payload provides the data associated with this message.
-     *
-     * @warning The function does not handle packet fragmentation. If the payload exceeds the size of a typical UDP packet,
-     * consider splitting the payload into smaller packets before sending.
+     * A payload larger than `FRAGMENT_SIZE` is fragmented by `sendPacket()` and reassembled by the
+     * recipient before its handler is called, up to `MAX_MESSAGE_SIZE`. A fragmented message is lost
+     * if any of its fragments is: send large messages on the reliable channel if they must arrive.
      *
      * @code
      * // Example usage:
-     * std::vector<uint8_t> payload = {0x01, 0x02, 0x03}; // Payload data
-     * networkService.sendRequest("127.0.0.1", 12345, static_cast<uint8_t>(GDTPMessageType::PlayerMovement), payload);
+     * const asio::ip::udp::endpoint server = NetworkingService::resolve("127.0.0.1", 12345); // Once
+     * networkService.sendRequest(server, static_cast<uint8_t>(GDTPMessageType::PlayerMovement), {0x01, 0x02, 0x03});
      * @endcode
      *
      * @see sendPacket() for how the constructed packet is sent.
      */
     GDTPHeader sendRequest(
-        const std::string& recipient,
-        const int port,
+        const asio::ip::udp::endpoint& recipient,
         const uint8_t messageType,
         const std::vector<uint8_t>& payload = {}
     ) {
-        GDTPHeader header{};
-        header.version = 0x01;
-        header.messageType = messageType;
-        header.packetId = std::chrono::system_clock::now().time_since_epoch().count();
-        header.payloadSize = static_cast<uint16_t>(payload.size());
-        header.sequenceNumber = 1;
-        header.totalPackets = 1;
-
-        std::vector<uint8_t> headerBuffer = header.toBuffer();
+        const GDTPHeader header = requestHeader(messageType, payload.size());
 
-        headerBuffer.insert(headerBuffer.end(), payload.begin(), payload.end());
-
-        sendPacket(headerBuffer, recipient, port);
+        if (!needsFraming(message_handlers->channels[messageType])) {
+            sendPacket(header, payload, recipient);
+            return header;
+        }
+        if (const auto framed = frame(recipient, messageType, payload, header.packetId)) {
+            sendPacket(requestHeader(framed->messageType, framed->payload.size(), header.packetId), framed->payload, recipient);
+        }
         return header;
     }
 
+    /**
+     * @brief Sends a UDP request to the recipient at the given IP address and port.
+     *
+     * Convenience overload of `sendRequest()` for one-off messages: the address is parsed on every call.
+     * Resolve the recipient once with `resolve()` and send to the endpoint for repeated traffic.
+     *
+     * @param recipient The IP address of the recipient to which the packet will be sent.
+     * @param port The port number on the recipient's side where the packet will be sent.
+     * @param messageType The type of the GDTP message to be sent.
+     * @param payload The payload data to be sent with the message. Defaults to an empty vector.
+     */
+    GDTPHeader sendRequest(
+        const std::string& recipient,
+        const int port,
+        const uint8_t messageType,
+        const std::vector<uint8_t>& payload = {}
+    ) {
+        return sendRequest(resolve(recipient, port), messageType, payload);
+    }
 
     /**
     * @brief Sends a response to a specific recipient using the given header as a basis.
@@ -209,8 +458,7 @@ public:
     * are set to default values (1). The method then composes the header and payload
     * into a complete message and sends it using the `sendPacket` method.
     *
-    * @param recipient The IP address of the recipient as a string (e.g., "127.0.0.1").
-    * @param port The port number of the recipient to which the message should be sent.
+    * @param client_endpoint The UDP endpoint of the client, which includes the IP address and port.
     * @param headerOrigin The original `GDTPHeader` from the request, which serves as the basis
     *                     for the response header.
     * @param payload The payload data to be sent with the response. Defaults to an empty vector.
@@ -219,137 +467,182 @@ public:
     * - The method starts by creating a copy of `headerOrigin` to modify.
     * - The `payloadSize` of the header is updated to match the size of the provided `payload`.
     * - `sequenceNumber` and `totalPackets` are set to `1`, indicating that the message is sent
-    *   in a single packet.
-    * - The method then converts the header into a byte buffer using `toBuffer()` and appends
-    *   the `payload` to this buffer.
-    * - Finally, the combined header and payload are sent to the specified recipient using the
-    *   `sendPacket` method.
+    *   in a single packet, unless it is larger than `FRAGMENT_SIZE` and `sendPacket` fragments it.
+    * - Finally, the header and payload are written to the calling thread's send buffer and sent
+    *   to the specified recipient using the `sendPacket` method.
     *
     * @note The header's version and message type are preserved from the `headerOrigin`, allowing
-    *       the response to maintain consistency with the original request.
-    *
-    * @throws std::runtime_error if the `sendPacket` method encounters an error during transmission.
+    *       the response to maintain consistency with the original request. The response is sent on the
+    *       channel of that message type, in an envelope that keeps the packet id if it needs one.
     *
     * @code
     * GDTPHeader originalHeader = ...; // Received or created earlier
     * std::vector<uint8_t> responsePayload = { ... }; // Data to include in the response
     *
-    * sendRequestResponse("192.168.1.100", 8080, originalHeader, responsePayload);
+    * sendRequestResponse(clientEndpoint, originalHeader, responsePayload);
     * // This sends a response using the header information from `originalHeader` and includes
     * // `responsePayload` as the data.
     * @endcode
     */
     GDTPHeader sendRequestResponse(
-        const std::string& recipient,
-        const int port,
+        const asio::ip::udp::endpoint& client_endpoint,
         const GDTPHeader& headerOrigin,
         const std::vector<uint8_t>& payload = {}
     ) {
-        GDTPHeader header = headerOrigin;
-        header.payloadSize = static_cast<uint16_t>(payload.size());
-        header.sequenceNumber = 1;
-        header.totalPackets = 1;
-
-        std::vector<uint8_t> headerBuffer = header.toBuffer();
+        const GDTPHeader header = responseHeader(headerOrigin, payload.size());
 
-        headerBuffer.insert(headerBuffer.end(), payload.begin(), payload.end());
-
-        sendPacket(headerBuffer, recipient, port);
+        if (!needsFraming(message_handlers->channels[headerOrigin.messageType])) {
+            sendPacket(header, payload, client_endpoint);
+            return header;
+        }
+        if (const auto framed = frame(client_endpoint, headerOrigin.messageType, payload, headerOrigin.packetId)) {
+            GDTPHeader envelopeHeader = responseHeader(headerOrigin, framed->payload.size());
+            envelopeHeader.messageType = framed->messageType;
+            sendPacket(envelopeHeader, framed->payload, client_endpoint);
+        }
         return header;
     }
 
-
     /**
-    * @brief Sends a response to a specific recipient using the given header as a basis.
+    * @brief Sends a response to the recipient at the given IP address and port.
     *
-    * This method is designed to send a response message to a specified recipient by reusing
-    * the `GDTPHeader` from an initial request. The payload size is automatically adjusted
-    * based on the provided payload, and the header's sequence number and total packets
-    * are set to default values (1). The method then composes the header and payload
-    * into a complete message and sends it using the `sendPacket` method.
+    * Convenience overload of `sendRequestResponse()`: the address is parsed on every call.
     *
-    * @param client_endpoint The UDP endpoint of the client, which includes the IP address and port.
+    * @param recipient The IP address of the recipient as a string (e.g., "127.0.0.1").
+    * @param port The port number of the recipient to which the message should be sent.
     * @param headerOrigin The original `GDTPHeader` from the request, which serves as the basis
     *                     for the response header.
     * @param payload The payload data to be sent with the response. Defaults to an empty vector.
-    *
-    * @details
-    * - The method starts by creating a copy of `headerOrigin` to modify.
-    * - The `payloadSize` of the header is updated to match the size of the provided `payload`.
-    * - `sequenceNumber` and `totalPackets` are set to `1`, indicating that the message is sent
-    *   in a single packet.
-    * - The method then converts the header into a byte buffer using `toBuffer()` and appends
-    *   the `payload` to this buffer.
-    * - Finally, the combined header and payload are sent to the specified recipient using the
-    *   `sendPacket` method.
-    *
-    * @note The header's version and message type are preserved from the `headerOrigin`, allowing
-    *       the response to maintain consistency with the original request.
-    *
-    * @throws std::runtime_error if the `sendPacket` method encounters an error during transmission.
-    *
-    * @code
-    * GDTPHeader originalHeader = ...; // Received or created earlier
-    * std::vector<uint8_t> responsePayload = { ... }; // Data to include in the response
-    *
-    * sendRequestResponse("192.168.1.100", 8080, originalHeader, responsePayload);
-    * // This sends a response using the header information from `originalHeader` and includes
-    * // `responsePayload` as the data.
-    * @endcode
     */
     GDTPHeader sendRequestResponse(
-        const asio::ip::udp::endpoint& client_endpoint,
+        const std::string& recipient,
+        const int port,
         const GDTPHeader& headerOrigin,
         const std::vector<uint8_t>& payload = {}
     ) {
-        return sendRequestResponse(client_endpoint.address().to_string(), client_endpoint.port(), headerOrigin, payload);
+        return sendRequestResponse(resolve(recipient, port), headerOrigin, payload);
     }
 
     /**
-     * @brief Sends a request to a client over UDP using the given endpoint.
+     * @brief Builds the endpoint of a recipient from its IP address and port.
      *
-     * This function sends a message to the specified client using their UDP endpoint. The message is composed of a header
-     * and an optional payload. The header contains the message type, and the payload can include additional data as needed.
+     * Meant to be called once per peer, e.g. when reading the server address from the configuration,
+     * so that the send path never parses addresses.
      *
-     * @param client_endpoint The UDP endpoint of the client, which includes the IP address and port.
-     * @param messageType The type of the message being sent. This is an 8-bit unsigned integer that identifies the type of the message.
-     * @param payloads An optional vector of bytes that represents the payload to send along with the request. By default,
-     * this is an empty vector if no payload is provided.
+     * @param address The IP address of the recipient, IPv4 or IPv6.
+     * @param port The UDP port of the recipient.
+     * @return The endpoint to pass to `sendRequest()` and `sendRequestResponse()`.
      *
-     * @note This function calls an overloaded version of `sendRequest` that takes the client's IP address as a string
-     * and their port number as arguments. It simplifies the process by allowing the user to pass an ASIO UDP endpoint directly.
+     * @throws std::system_error If the address is not a valid IP address.
+     */
+    static asio::ip::udp::endpoint resolve(const std::string& address, const int port) {
+        return {asio::ip::make_address(address), static_cast<unsigned short>(port)};
+    }
+
+    /**
+     * @brief Sends queued packets, in order.
      *
-     * @code
-     * asio::ip::udp::endpoint clientEndpoint(asio::ip::address::from_string("127.0.0.1"), 8080);
-     * uint8_t messageType = 1; // Example message type
-     * std::vector<uint8_t> payload = {0x01, 0x02, 0x03}; // Example payload
-     * sendRequest(clientEndpoint, messageType, payload);
-     * @endcode
+     * In batched I/O mode on Linux, the packets are written to the socket `IO_BATCH_SIZE` at a time
+     * with `sendmmsg`, one system call for the whole batch, and with the io_uring transport they are
+     * submitted `IO_BATCH_SIZE` at a time to a ring. Otherwise, or on other platforms, each packet
+     * is sent on its own with `send_to`.
+     *
+     * @param packets The packets to send. Requests get a fresh header, responses reuse the one of the request.
+     *                The packets are sent as they are: their messages are not framed for their channel.
+     *                Those larger than a datagram are fragmented and sent on their own, in order.
+     *
+     * @see setBatchedIo()
+     * @see frame()
      */
-    GDTPHeader sendRequest(
-        const asio::ip::udp::endpoint& client_endpoint,
-        const uint8_t messageType,
-        const std::vector<uint8_t>& payloads = {}
-    ) {
-        return sendRequest(client_endpoint.address().to_string(), client_endpoint.port(), messageType, payloads);
+    void sendPackets(const std::span<const OutboundPacket> packets) {
+        std::size_t first = 0;
+        for (std::size_t i = 0; i < packets.size(); i++) {
+            if (packets[i].payload.size() <= FRAGMENT_SIZE) {
+                continue;
+            }
+            sendDatagrams(packets.subspan(first, i - first));
+            sendPacket(outboundHeader(packets[i]), packets[i].payload, packets[i].endpoint);
+            first = i + 1;
+        }
+        sendDatagrams(packets.subspan(first));
+    }
+
+    /**
+     * @brief Enables or disables batched I/O, where the platform supports it.
+     *
+     * On Linux, batched I/O receives up to `IO_BATCH_SIZE` datagrams each time the socket becomes
+     * readable with `recvmmsg`, and `sendPackets()` flushes its packets with `sendmmsg`, which saves
+     * system calls when many clients are connected. Elsewhere the flag has no effect and the ASIO
+     * path is used.
+     *
+     * @param enabled Whether batched I/O should be used.
+     *
+     * @note Call it before `init()` or `run()`: the receive loop checks the flag each time it is rearmed.
+     */
+    void setBatchedIo(const bool enabled) {
+        batched_io_ = enabled;
+    }
+
+    /**
+     * @brief Selects the backend used for the socket, before `init()` or `run()`.
+     *
+     * The io_uring transport receives with a single multishot request into buffers registered with the
+     * kernel, so that a datagram costs no system call, and `sendPackets()` submits its batches to a ring.
+     * It exposes the same `addEvent()` and send API. Where io_uring is not available (other platforms,
+     * older kernels, or io_uring disabled), the service falls back to the ASIO transport and logs it.
+     *
+     * @param transport The backend to use.
+     */
+    void setTransport(const Transport transport) {
+        transport_ = transport;
+    }
+
+    /**
+     * @brief Sets the number of sockets the service receives on, each with its own network thread.
+     *
+     * On Linux, the sockets are all bound to the service port with `SO_REUSEPORT`, and the kernel picks the
+     * socket of a datagram from a hash of its source and destination addresses: the messages of a client
+     * always arrive on the same socket, and are handled in order by the same thread. Handlers of different
+     * clients then run concurrently and must be thread-safe. Elsewhere a single socket is used.
+     *
+     * @param count The number of sockets and receive threads, at least 1.
+     *
+     * @note Call it before `init()` or `run()`.
+     */
+    void setReceiveThreads(const std::size_t count) {
+        receive_threads_ = std::max<std::size_t>(count, 1);
+    }
+
+    /**
+     * @brief Gets the backend actually in use, once the service is initialized.
+     */
+    [[nodiscard]] Transport getTransport() const {
+#ifdef NETWORK_HAS_IO_URING
+        if (!shards_.empty() && shards_.front()->recv_ring) {
+            return Transport::IoUring;
+        }
+#endif
+        return Transport::Asio;
     }
 
 
     /**
      * @brief Starts the asynchronous reception of UDP packets.
      *
-     * This method sets up the `NetworkingService` to continuously listen for incoming UDP packets.
-     * It uses the ASIO library's `async_receive_from` function to asynchronously receive data from
-     * remote endpoints without blocking the execution.
+     * This method sets up the `NetworkingService` to continuously listen for incoming UDP packets
+     * on each of its sockets. It uses the ASIO library's `async_receive_from` function to asynchronously
+     * receive data from remote endpoints without blocking the execution.
      *
      * @details
-     * - The method sets up a buffer (`recv_buffer_`) to store the incoming packet data and listens
-     *   for packets from any client, storing the sender's endpoint in `remote_endpoint_`.
+     * - The method sets up a buffer (`Shard::recv_buffer`) to store the incoming packet data and listens
+     *   for packets from any client, storing the sender's endpoint in `Shard::remote_endpoint`.
      * - Once a packet is received, it triggers a lambda function that checks if the reception
      *   was successful (i.e., no errors and non-zero bytes received).
      * - If successful, the method calls `handleReceivedPacket()` to process the received data.
      * - After processing, it immediately calls `startReceive()` again to continue listening for
      *   more incoming packets, thus ensuring a continuous reception loop.
+     * - In batched I/O mode on Linux, it instead waits for the socket to become readable and
+     *   reads every waiting datagram, up to `IO_BATCH_SIZE`, with `receiveBatch()`.
      *
      * @param ec The error code passed by the ASIO callback, indicating if an error occurred
      *        during packet reception.
@@ -372,32 +665,27 @@ public:
      * @see `run()` for starting the I/O context in a separate thread.
      */
     void startReceive() {
-        if (!socket_.has_value()) {
+        if (shards_.empty()) {
             throw std::runtime_error("Socket is not initialized");
         }
-        socket_->async_receive_from(
-            asio::buffer(recv_buffer_), remote_endpoint_,
-            [this](const std::error_code ec, const std::size_t bytes_recvd) {
-                if (!ec && bytes_recvd > 0) {
-                    handleReceivedPacket(recv_buffer_, bytes_recvd, remote_endpoint_);
-                }
-                startReceive(); // Continue listening for more packets.
-            }
-        );
+        for (const auto& shard : shards_) {
+            startReceive(*shard);
+        }
     }
 
     /**
      * @brief Initializes the networking service by setting up the UDP socket.
      *
      * This function sets up the UDP socket for the networking service. It ensures that the
-     * socket is only initialized once by using a static `isInit` flag. If the socket has already
+     * socket is only initialized once by using an `initialized_` flag. If the socket has already
      * been initialized, subsequent calls to this function will have no effect.
      *
      * @details
-     * - The function checks if the `isInit` flag is `false`, indicating that the socket has not been initialized.
+     * - The function checks if the `initialized_` flag is `false`, indicating that the socket has not been initialized.
      * - It then attempts to create a new `asio::ip::udp::socket` using the provided I/O context and binds it
-     *   to a UDP endpoint with the specified port.
-     * - If the initialization is successful, `isInit` is set to `true` to prevent future reinitializations.
+     *   to a UDP endpoint with the specified port, or one socket per receive thread with `SO_REUSEPORT`.
+     * - If the initialization is successful, `initialized_` is set to `true` to prevent future reinitializations.
+     * - With the io_uring transport, the rings are set up; otherwise the ASIO receive loop is started.
      * - If an exception occurs during socket creation, it is caught and the error message is printed to `std::cerr`.
      *
      * @note This function is automatically called inside the `run()` method if it has not been called before.
@@ -417,16 +705,30 @@ public:
      */
     void init()
     {
-        static bool isInit = false;
-        if (isInit)
+        if (initialized_)
             return;
 
         try {
-            socket_ = asio::ip::udp::socket(io_context_, asio::ip::udp::endpoint(asio::ip::udp::v4(), _port));
-            isInit = true;
-            startReceive();
+#ifdef __linux__
+            const std::size_t count = receive_threads_;
+#else
+            const std::size_t count = 1;
+            if (receive_threads_ > 1) {
+                std::cerr << "SO_REUSEPORT sharding not supported on this platform, receiving on one socket" << std::endl;
+            }
+#endif
+            for (std::size_t i = 0; i < count; i++) {
+                // The other sockets join the port of the first one, which the system picked if it was 0
+                const int port = i == 0 ? _port : static_cast<int>(shards_.front()->socket->local_endpoint().port());
+                shards_.push_back(openShard(port, count > 1));
+            }
+            initialized_ = true;
+            if (!setupIoUring()) {
+                startReceive();
+            }
             std::cout << "Network service initialized on port : " << _port << std::endl;
         } catch (std::exception &e) {
+            shards_.clear();
             std::cerr << "Error in Network service: " << e.what() << std::endl;
             throw std::runtime_error("Failed to initialize network service");
         }
@@ -435,14 +737,15 @@ public:
     /**
      * @brief Runs the NetworkingService in a separate thread.
      *
-     * This method initiates the ASIO I/O context in a new thread, allowing the `NetworkingService`
+     * This method initiates the ASIO I/O context of each socket in a new thread, allowing the `NetworkingService`
      * to perform asynchronous network operations without blocking the main thread.
      *
      * @details
      * - The method creates a new `std::jthread`, which automatically manages thread creation and
      *   cleanup when the thread is no longer needed.
-     * - Inside the thread, it calls `io_context_.run()`, which processes incoming events,
-     *   such as network operations, asynchronously.
+     * - Inside each thread, it runs the `io_context` of one socket, which processes incoming events,
+     *   such as network operations, asynchronously. With the io_uring transport, the thread
+     *   runs the completion loop of the receive ring instead.
      * - Using a separate thread ensures that the network service can continue to send, receive,
      *   and process packets in the background, enabling the main thread to perform other tasks
      *   without being blocked by network operations.
@@ -465,10 +768,17 @@ public:
      */
     void run() {
         init();
-        thread = std::jthread([this] {
-            io_context_.run();
-        });
-
+        for (const auto& shard : shards_) {
+            shard->thread = std::jthread([this, &shard = *shard](const std::stop_token& stopToken) {
+#ifdef NETWORK_HAS_IO_URING
+                if (shard.recv_ring) {
+                    receiveIoUring(shard, stopToken);
+                    return;
+                }
+#endif
+                shard.io_context.run();
+            });
+        }
     }
 
 
@@ -480,7 +790,7 @@ public:
      * are terminated safely and prevents further processing.
      *
      * @details
-     * - The `io_context_.stop()` call stops any asynchronous operations, effectively ending the
+     * - The `io_context.stop()` call of each socket stops any asynchronous operations, effectively ending the
      *   event loop used by `asio` for networking.
      * - The `request_stop()` function on the `std::jthread` object requests the thread running the
      *   service to stop its execution.
@@ -500,8 +810,10 @@ public:
      */
     void stop()
     {
-        io_context_.stop();
-        thread.request_stop();
+        for (const auto& shard : shards_) {
+            shard->io_context.stop();
+            shard->thread.request_stop();
+        }
     }
 
 
@@ -535,7 +847,11 @@ public:
      */
     void attempt()
     {
-        thread.join();
+        for (const auto& shard : shards_) {
+            if (shard->thread.joinable()) {
+                shard->thread.join();
+            }
+        }
     }
 
 
@@ -559,72 +875,579 @@ public:
     };
 
 private:
-    asio::io_context io_context_;                   ///< ASIO I/O context for handling asynchronous network operations.
-    std::optional<asio::ip::udp::socket> socket_;    ///< ASIO UDP socket for sending and receiving packets.
+    /**
+     * @brief A socket bound to the service port, with the state of its receive loop and the thread running it.
+     */
+    struct Shard {
+        asio::io_context io_context;                   ///< ASIO I/O context of the socket's asynchronous operations.
+        std::optional<asio::ip::udp::socket> socket;   ///< ASIO UDP socket for receiving packets, the first one also sends.
+        asio::ip::udp::endpoint remote_endpoint;       ///< Endpoint of the remote client sending the packet.
+        std::array<uint8_t, RECV_BUFFER_SIZE> recv_buffer{}; ///< Buffer reused for every incoming packet, handlers get views into it.
+        Reassembler reassembler{FRAGMENT_SIZE};        ///< Fragmented messages of the peers hashed to this socket.
+#ifdef NETWORK_HAS_IO_URING
+        std::optional<IoUring> recv_ring;              ///< Ring of the multishot receive, used by the shard's thread only.
+        std::optional<IoUringBufferRing> recv_pool;    ///< Buffers the kernel receives the datagrams into.
+        msghdr recv_msghdr{};                          ///< Layout of the multishot receive: sender address, no control data.
+#endif
+#ifdef __linux__
+        std::array<std::array<uint8_t, RECV_BUFFER_SIZE>, IO_BATCH_SIZE> recv_buffers{}; ///< Buffers for the datagrams of a batched receive.
+        std::array<sockaddr_storage, IO_BATCH_SIZE> recv_addresses{};       ///< Senders of the datagrams of a batched receive.
+        std::array<iovec, IO_BATCH_SIZE> recv_iovecs{};                     ///< Scatter entries pointing at `recv_buffers`.
+        std::array<mmsghdr, IO_BATCH_SIZE> recv_messages{};                 ///< Message headers passed to `recvmmsg`.
+#endif
+        std::jthread thread;                           ///< Thread running the receive loop, destroyed first.
+    };
+
     int _port;                                      ///< Port number for the server to listen on.
-    asio::ip::udp::endpoint remote_endpoint_;       ///< Endpoint of the remote client sending the packet.
-    std::array<uint8_t, 1400> recv_buffer_{};         ///< Buffer for receiving incoming packets.
-    std::jthread thread;                            ///< Thread for running the ASIO I/O context.
-    std::shared_ptr<std::map<uint8_t, std::function<void(const GDTPHeader&, const std::vector<uint8_t>&, const asio::ip::udp::endpoint&)>>> message_handlers; ///< Handlers for processing received messages.
+    std::vector<std::unique_ptr<Shard>> shards_;    ///< Sockets bound to the port, one per receive thread.
+    std::size_t receive_threads_ = 1;               ///< Number of sockets requested with `setReceiveThreads()`.
+    bool initialized_ = false;                      ///< Whether the sockets have been created.
+    bool batched_io_ = false;                       ///< Whether datagrams are received and sent in batches, on Linux.
+    Transport transport_ = Transport::Asio;         ///< Backend requested with `setTransport()`.
+#ifdef NETWORK_HAS_IO_URING
+    std::optional<IoUring> send_ring_;               ///< Ring the sent batches are submitted to.
+    std::mutex send_mutex_;                         ///< Serializes the senders on `send_ring_`.
+#endif
 
     /**
-     * @brief Sends a UDP packet to the specified recipient.
+     * @brief Gets the socket packets are sent from, the first one bound to the port.
+     * @throws std::runtime_error If the service is not initialized.
+     */
+    [[nodiscard]] asio::ip::udp::socket& primarySocket() const {
+        if (shards_.empty()) {
+            throw std::runtime_error("Socket is not initialized");
+        }
+        return *shards_.front()->socket;
+    }
+
+    /**
+     * @brief Creates a socket and binds it to a port, shared with the other sockets if @p reusePort is set.
+     */
+    static std::unique_ptr<Shard> openShard(const int port, [[maybe_unused]] const bool reusePort) {
+        auto shard = std::make_unique<Shard>();
+        shard->socket.emplace(shard->io_context, asio::ip::udp::v4());
+#ifdef __linux__
+        if (reusePort) {
+            const int enabled = 1;
+            if (::setsockopt(shard->socket->native_handle(), SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled)) < 0) {
+                throw std::system_error(errno, std::system_category(), "setsockopt(SO_REUSEPORT)");
+            }
+        }
+#endif
+        shard->socket->bind(asio::ip::udp::endpoint(asio::ip::udp::v4(), static_cast<unsigned short>(port)));
+        return shard;
+    }
+
+    /**
+     * @brief Starts the receive loop of one socket, see the public `startReceive()`.
+     */
+    void startReceive(Shard& shard) {
+#ifdef __linux__
+        if (batched_io_) {
+            shard.socket->async_wait(asio::ip::udp::socket::wait_read, [this, &shard](const std::error_code ec) {
+                if (!ec) {
+                    receiveBatch(shard);
+                }
+                startReceive(shard); // Continue listening for more packets.
+            });
+            return;
+        }
+#endif
+        shard.socket->async_receive_from(
+            asio::buffer(shard.recv_buffer), shard.remote_endpoint,
+            [this, &shard](const std::error_code ec, const std::size_t bytes_recvd) {
+                if (!ec && bytes_recvd > 0) {
+                    handleReceivedPacket(shard, std::span(shard.recv_buffer).first(bytes_recvd), shard.remote_endpoint);
+                }
+                startReceive(shard); // Continue listening for more packets.
+            }
+        );
+    }
+
+    /**
+     * @brief Builds the header of a new, unfragmented request, with a fresh packet id unless one is given.
+     */
+    static GDTPHeader requestHeader(const uint8_t messageType, const std::size_t payloadSize, const std::optional<uint64_t> packetId = std::nullopt) {
+        GDTPHeader header{};
+        header.version = 0x01;
+        header.messageType = messageType;
+        header.packetId = packetId.value_or(std::chrono::system_clock::now().time_since_epoch().count());
+        header.payloadSize = static_cast<uint16_t>(payloadSize);
+        header.sequenceNumber = 1;
+        header.totalPackets = 1;
+        return header;
+    }
+
+    /**
+     * @brief Builds the header of an unfragmented response from the header of the request.
+     */
+    static GDTPHeader responseHeader(const GDTPHeader& headerOrigin, const std::size_t payloadSize) {
+        GDTPHeader header = headerOrigin;
+        header.payloadSize = static_cast<uint16_t>(payloadSize);
+        header.sequenceNumber = 1;
+        header.totalPackets = 1;
+        return header;
+    }
+
+    /**
+     * @brief Builds the header of a queued packet: a fresh one for a request, the request's for a response.
+     */
+    static GDTPHeader outboundHeader(const OutboundPacket& packet) {
+        return packet.response
+            ? responseHeader(*packet.response, packet.payload.size())
+            : requestHeader(packet.messageType, packet.payload.size());
+    }
+
+    /**
+     * @brief Sends queued packets that each fit a datagram, batched if the transport or the I/O mode allows it.
+     */
+    void sendDatagrams(const std::span<const OutboundPacket> packets) {
+#ifdef NETWORK_HAS_IO_URING
+        if (send_ring_) {
+            std::lock_guard lock(send_mutex_);
+            for (std::size_t offset = 0; offset < packets.size(); offset += IO_BATCH_SIZE) {
+                sendIoUring(packets.subspan(offset, std::min(IO_BATCH_SIZE, packets.size() - offset)));
+            }
+            return;
+        }
+#endif
+#ifdef __linux__
+        if (batched_io_) {
+            for (std::size_t offset = 0; offset < packets.size(); offset += IO_BATCH_SIZE) {
+                sendBatch(packets.subspan(offset, std::min(IO_BATCH_SIZE, packets.size() - offset)));
+            }
+            return;
+        }
+#endif
+        for (const auto& packet : packets) {
+            sendPacket(outboundHeader(packet), packet.payload, packet.endpoint);
+        }
+    }
+
+#ifdef __linux__
+    /**
+     * @brief Reads the datagrams waiting on the socket, up to `IO_BATCH_SIZE`, with a single `recvmmsg`.
      *
-     * This method is responsible for transmitting a UDP packet to a given recipient's IP address and port.
-     * It constructs the appropriate endpoint from the provided address and port and attempts to send
-     * the packet using the `asio` library's `send_to` function.
+     * Every datagram is then handled by `handleReceivedPacket()`, like one received by `async_receive_from`.
+     * Truncated datagrams, larger than a receive buffer, are dropped.
+     */
+    void receiveBatch(Shard& shard) {
+        for (std::size_t i = 0; i < IO_BATCH_SIZE; i++) {
+            shard.recv_iovecs[i] = {shard.recv_buffers[i].data(), shard.recv_buffers[i].size()};
+            shard.recv_messages[i] = {};
+            shard.recv_messages[i].msg_hdr.msg_name = &shard.recv_addresses[i];
+            shard.recv_messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+            shard.recv_messages[i].msg_hdr.msg_iov = &shard.recv_iovecs[i];
+            shard.recv_messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int received = ::recvmmsg(shard.socket->native_handle(), shard.recv_messages.data(), IO_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        for (int i = 0; i < received; i++) {
+            const msghdr& message = shard.recv_messages[i].msg_hdr;
+            asio::ip::udp::endpoint sender;
+            if ((message.msg_flags & MSG_TRUNC) || !toEndpoint(&shard.recv_addresses[i], message.msg_namelen, sender)) {
+                continue;
+            }
+            handleReceivedPacket(shard, std::span(shard.recv_buffers[i]).first(shard.recv_messages[i].msg_len), sender);
+        }
+    }
+
+    /**
+     * @brief Copies a socket address filled by the kernel into an endpoint.
+     * @return false if the address does not fit an endpoint.
+     */
+    static bool toEndpoint(const void* address, const socklen_t length, asio::ip::udp::endpoint& endpoint) {
+        if (length > endpoint.capacity()) {
+            return false;
+        }
+        std::memcpy(endpoint.data(), address, length);
+        endpoint.resize(length);
+        return true;
+    }
+
+    /**
+     * @brief Builds up to `IO_BATCH_SIZE` packets in buffers owned by the calling thread.
      *
-     * @param packet A `std::vector<uint8_t>` containing the packet data, which typically includes a serialized
-     *               header followed by the payload data. The data in the vector will be transmitted as-is
-     *               over the network.
-     * @param recipient A `std::string` representing the IP address of the recipient. This can be in IPv4
-     *                  or IPv6 format, depending on the target's address.
-     * @param port An `int` representing the UDP port number of the recipient. This port is where the recipient
-     *             is expected to listen for incoming UDP packets.
+     * The buffers are reused from one batch to the next, so that sending does not allocate once they
+     * reached the size of the largest packet.
      *
-     * @details
-     * - The method constructs an `asio::ip::udp::endpoint` using the recipient's IP address and port.
-     * - It then calls `socket_.send_to()` with the constructed endpoint and the packet data, wrapped in an
-     *   `asio::buffer`. If the operation fails, it captures the error code.
-     * - In case of an error during the send operation, the method throws a `std::runtime_error` with a
-     *   descriptive error message, making it easier to debug connection issues.
-     * - The method ensures that the packet is sent asynchronously using `asio` to avoid blocking the main thread.
+     * @return The message headers of the packets, ready for `sendmmsg` or an io_uring `SENDMSG`.
+     */
+    static std::span<mmsghdr> prepareBatch(const std::span<const OutboundPacket> packets) {
+        thread_local std::array<std::vector<uint8_t>, IO_BATCH_SIZE> buffers;
+        thread_local std::array<iovec, IO_BATCH_SIZE> iovecs;
+        thread_local std::array<mmsghdr, IO_BATCH_SIZE> messages;
+
+        for (std::size_t i = 0; i < packets.size(); i++) {
+            const OutboundPacket& packet = packets[i];
+            const GDTPHeader header = outboundHeader(packet);
+
+            std::vector<uint8_t>& buffer = buffers[i];
+            buffer.resize(HEADER_SIZE + packet.payload.size());
+            header.toBuffer(buffer);
+            std::ranges::copy(packet.payload, buffer.begin() + HEADER_SIZE);
+
+            iovecs[i] = {buffer.data(), buffer.size()};
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = const_cast<sockaddr*>(packet.endpoint.data());
+            messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(packet.endpoint.size());
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        return std::span(messages).first(packets.size());
+    }
+
+    /**
+     * @brief Writes up to `IO_BATCH_SIZE` packets to the socket with `sendmmsg`.
      *
-     * @code
-     * // Example usage in a NetworkingService class:
-     * std::vector<uint8_t> packetData = ...; // Prepare packet with header and payload
-     * std::string recipientIP = "192.168.1.100";
-     * int recipientPort = 12345;
-     *
-     * try {
-     *     sendPacket(packetData, recipientIP, recipientPort);
-     *     std::cout << "Packet sent successfully." << std::endl;
-     * } catch (const std::runtime_error& e) {
-     *     std::cerr << "Failed to send packet: " << e.what() << std::endl;
-     * }
-     * @endcode
+     * A packet the kernel refuses is logged and dropped, like a failed `send_to`, and the rest of the
+     * batch is still sent.
+     */
+    void sendBatch(const std::span<const OutboundPacket> packets) {
+        asio::ip::udp::socket& socket = primarySocket();
+        const std::span<mmsghdr> messages = prepareBatch(packets);
+
+        std::size_t sent = 0;
+        while (sent < messages.size()) {
+            const int result = ::sendmmsg(socket.native_handle(), &messages[sent], static_cast<unsigned int>(messages.size() - sent), 0);
+            if (result >= 0) {
+                sent += static_cast<std::size_t>(result);
+                continue;
+            }
+            const int error = errno;
+            if (error == EINTR) {
+                continue;
+            }
+            // ASIO keeps the socket non-blocking for its asynchronous receive
+            if (error == EAGAIN || error == EWOULDBLOCK) {
+                std::error_code ec;
+                socket.wait(asio::ip::udp::socket::wait_write, ec);
+                if (!ec) {
+                    continue;
+                }
+            }
+            std::cout << "Failed to send packet: " << std::strerror(error) << std::endl;
+            sent++;
+        }
+    }
+#endif
+
+    /**
+     * @brief Sets up the io_uring transport, if it was selected with `setTransport()`.
      *
-     * @throws std::runtime_error If the `send_to` operation fails, an exception is thrown with the
-     *         error message provided by `asio`. This exception should be caught by the caller to
-     *         handle network errors gracefully.
+     * @return true if the rings are ready; false if the ASIO transport is used, because it was selected
+     *         or because io_uring is not available, which is logged.
+     */
+    bool setupIoUring() {
+        if (transport_ != Transport::IoUring) {
+            return false;
+        }
+#ifdef NETWORK_HAS_IO_URING
+        try {
+            // The kernel writes the recvmsg header, the sender address then the datagram in each buffer
+            for (const auto& shard : shards_) {
+                shard->recv_msghdr = {};
+                shard->recv_msghdr.msg_namelen = sizeof(sockaddr_storage);
+                shard->recv_ring.emplace(8, IO_URING_RECV_BUFFERS * 2);
+                shard->recv_pool.emplace(*shard->recv_ring, 0, IO_URING_RECV_BUFFERS,
+                    sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_storage) + shard->recv_buffer.size());
+            }
+            send_ring_.emplace(static_cast<unsigned>(IO_BATCH_SIZE));
+            return true;
+        } catch (const std::system_error& e) {
+            for (const auto& shard : shards_) {
+                shard->recv_pool.reset();
+                shard->recv_ring.reset();
+            }
+            send_ring_.reset();
+            std::cerr << "io_uring transport unavailable (" << e.what() << "), using asio" << std::endl;
+            return false;
+        }
+#else
+        std::cerr << "io_uring transport not supported on this platform, using asio" << std::endl;
+        return false;
+#endif
+    }
+
+#ifdef NETWORK_HAS_IO_URING
+    /**
+     * @brief Completion loop of the io_uring transport, run by the thread of a socket until it is stopped.
      *
-     * @warning Ensure that the recipient IP address and port are correct before calling this method.
-     *          An invalid address or port can lead to exceptions or failed transmissions.
+     * A single multishot `RECVMSG` posts a completion per datagram, each in a buffer of `Shard::recv_pool`
+     * that is given back as soon as the datagram is handled. The request is submitted again when the
+     * kernel ends it, e.g. after running out of buffers. If the kernel does not support multishot
+     * receives, the thread falls back to the ASIO receive loop.
+     */
+    void receiveIoUring(Shard& shard, const std::stop_token& stopToken) {
+        bool armed = false;
+        bool unsupported = false;
+
+        while (!stopToken.stop_requested() && !unsupported) {
+            if (!armed) {
+                io_uring_sqe* sqe = shard.recv_ring->getSqe();
+                sqe->opcode = IORING_OP_RECVMSG;
+                sqe->fd = shard.socket->native_handle();
+                sqe->addr = reinterpret_cast<uint64_t>(&shard.recv_msghdr);
+                sqe->len = 1;
+                sqe->ioprio = IORING_RECV_MULTISHOT;
+                sqe->flags = IOSQE_BUFFER_SELECT;
+                sqe->buf_group = shard.recv_pool->group();
+                armed = true;
+            }
+            shard.recv_ring->submit(1);
+
+            shard.recv_ring->drain([&](const io_uring_cqe& cqe) {
+                if (!(cqe.flags & IORING_CQE_F_MORE)) {
+                    armed = false;
+                }
+                if (cqe.res == -EINVAL) {
+                    unsupported = true;
+                }
+                if (cqe.res < 0 || !(cqe.flags & IORING_CQE_F_BUFFER)) {
+                    return;
+                }
+                const auto id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                const std::span<const uint8_t> buffer = shard.recv_pool->buffer(id).first(static_cast<std::size_t>(cqe.res));
+                handleRecvMsg(shard, buffer);
+                shard.recv_pool->recycle(id);
+            });
+        }
+
+        if (unsupported) {
+            std::cerr << "io_uring multishot receive unsupported by the kernel, using asio" << std::endl;
+            shard.recv_pool.reset();
+            shard.recv_ring.reset();
+            startReceive(shard);
+            shard.io_context.run();
+        }
+    }
+
+    /**
+     * @brief Handles a datagram written by a multishot `RECVMSG` in one of the receive buffers.
+     */
+    void handleRecvMsg(Shard& shard, const std::span<const uint8_t> buffer) const {
+        io_uring_recvmsg_out out{};
+        if (buffer.size() < sizeof(out)) {
+            return;
+        }
+        std::memcpy(&out, buffer.data(), sizeof(out));
+        const std::size_t payloadOffset = sizeof(out) + shard.recv_msghdr.msg_namelen + shard.recv_msghdr.msg_controllen;
+        if ((out.flags & MSG_TRUNC) || buffer.size() < payloadOffset || out.namelen > shard.recv_msghdr.msg_namelen) {
+            return;
+        }
+
+        asio::ip::udp::endpoint sender;
+        if (!toEndpoint(buffer.data() + sizeof(out), out.namelen, sender)) {
+            return;
+        }
+        const std::span<const uint8_t> packet = buffer.subspan(payloadOffset);
+        handleReceivedPacket(shard, packet.first(std::min<std::size_t>(out.payloadlen, packet.size())), sender);
+    }
+
+    /**
+     * @brief Submits up to `IO_BATCH_SIZE` packets to the send ring and waits for them to be sent.
+     *
+     * One `io_uring_enter` submits the batch and collects its completions. A packet the kernel refuses
+     * is logged and dropped, like a failed `send_to`.
+     */
+    void sendIoUring(const std::span<const OutboundPacket> packets) {
+        const int socket = primarySocket().native_handle();
+        const std::span<mmsghdr> messages = prepareBatch(packets);
+
+        for (mmsghdr& message : messages) {
+            io_uring_sqe* sqe = send_ring_->getSqe();
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->fd = socket;
+            sqe->addr = reinterpret_cast<uint64_t>(&message.msg_hdr);
+            sqe->len = 1;
+        }
+
+        std::size_t completed = 0;
+        while (completed < messages.size()) {
+            send_ring_->submit(static_cast<unsigned>(messages.size() - completed));
+            completed += send_ring_->drain([](const io_uring_cqe& cqe) {
+                if (cqe.res < 0) {
+                    std::cout << "Failed to send packet: " << std::strerror(-cqe.res) << std::endl;
+                }
+            });
+        }
+    }
+#endif
+    /**
+     * @brief Handlers of the received messages, indexed by message type.
+     */
+    struct HandlerTable {
+        std::array<MessageHandler, 256> handlers;   ///< Handlers set with `addEvent()`, empty for unhandled types.
+        std::shared_ptr<void> staticHandler;        ///< Object set with `setStaticHandlers()`, if any.
+        bool (*staticDispatch)(void*, uint8_t, const GDTPHeader&, std::span<const uint8_t>, const asio::ip::udp::endpoint&) = nullptr; ///< Dispatch generated for it.
+        std::array<Channel, 256> channels{};        ///< Channels set with `setChannel()`, unreliable by default.
+    };
+
+    std::shared_ptr<HandlerTable> message_handlers; ///< Handlers for processing received messages.
+
+    /**
+     * @brief Channels with every peer, shared by the network threads and the senders.
+     */
+    struct Peers {
+        std::mutex mutex;                                             ///< Guards `channels`.
+        std::map<asio::ip::udp::endpoint, PeerChannels> channels;     ///< State of the channels, per peer.
+        std::atomic<std::size_t> acksPending = 0;                     ///< Peers with an acknowledgement waiting, read without the lock.
+    };
+
+    std::unique_ptr<Peers> peers_; ///< Channels with the peers.
+
+    /**
+     * @brief Whether a message of a channel may have to travel in an envelope.
+     *
+     * Unreliable messages skip the peers' lock unless some acknowledgement waits to be sent.
+     */
+    bool needsFraming(const Channel channel) const {
+        return channel != Channel::Unreliable || peers_->acksPending.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+     * @brief Keeps `Peers::acksPending` up to date after an operation on a peer, under the peers' lock.
+     */
+    void countAck(const bool wasPending, const bool pending) const {
+        if (pending && !wasPending) {
+            peers_->acksPending.fetch_add(1, std::memory_order_relaxed);
+        } else if (!pending && wasPending) {
+            peers_->acksPending.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Draws the session of the channels with a new peer, never 0.
+     */
+    static uint16_t newSession() {
+        thread_local std::mt19937 generator(std::random_device{}());
+        return std::uniform_int_distribution<uint16_t>(1, UINT16_MAX)(generator);
+    }
+
+    /**
+     * @brief Opens an envelope and hands the messages it delivers to their handlers.
      *
-     * @see `asio::ip::udp::endpoint` for more information about constructing network endpoints.
+     * The messages are collected under the peers' lock and handled once it is released, so that handlers
+     * can send. They view the envelope, or the payloads released from the reorder buffer: none is copied.
+     * Envelopes of new peers are dropped while `MAX_PEERS` peers have channels.
+     */
+    void openEnvelope(
+        const std::span<const uint8_t> payload,
+        const GDTPHeader& header,
+        const asio::ip::udp::endpoint& client_endpoint
+    ) const {
+        PeerChannels::Delivered delivered;
+        bool valid = false;
+        {
+            std::lock_guard lock(peers_->mutex);
+            auto it = peers_->channels.find(client_endpoint);
+            if (it == peers_->channels.end()) {
+                if (peers_->channels.size() >= MAX_PEERS) {
+                    std::cerr << "Too many peers, dropping envelope from " << client_endpoint << std::endl;
+                    return;
+                }
+                it = peers_->channels.emplace(client_endpoint, PeerChannels(newSession())).first;
+            }
+            PeerChannels& peer = it->second;
+            const bool wasPending = peer.ackPending();
+            valid = peer.receive(payload, PeerChannels::Clock::now(), delivered);
+            countAck(wasPending, peer.ackPending());
+        }
+        if (!valid) {
+            std::cerr << "Received malformed envelope" << std::endl;
+        }
+
+        for (const auto& [messageType, message] : delivered.messages) {
+            if (messageType == ENVELOPE_MESSAGE) {
+                continue;
+            }
+            GDTPHeader messageHeader = header;
+            messageHeader.messageType = messageType;
+            messageHeader.payloadSize = static_cast<uint16_t>(message.size());
+            processMessage(messageType, message, messageHeader, client_endpoint);
+        }
+    }
+
+    /**
+     * @brief Calls the overload of @p handler for @p messageType, if it is one of @p MessageTypes.
+     * @return Whether the message was handled.
+     */
+    template <typename Handler, uint8_t... MessageTypes>
+    static bool dispatchStatic(
+        void* handler,
+        const uint8_t messageType,
+        const GDTPHeader& header,
+        const std::span<const uint8_t> payload,
+        const asio::ip::udp::endpoint& client_endpoint
+    ) {
+        Handler& typed = *static_cast<Handler*>(handler);
+        return ((messageType == MessageTypes && (typed(Message<MessageTypes>{}, header, payload, client_endpoint), true)) || ...);
+    }
+
+    /**
+     * @brief Sends a UDP packet to the specified recipient.
+     *
+     * This method is responsible for transmitting a GDTP packet to an already resolved endpoint.
+     * The header and the payload are written one after the other in a send buffer owned by the
+     * calling thread, then sent with the `asio` library's `send_to` function. A payload larger than
+     * `FRAGMENT_SIZE` is sent in fragments of that size, the last one shorter, which share the
+     * header's packet id and are numbered from 1 in `sequenceNumber` out of `totalPackets`.
+     *
+     * @param header The header of the packet, serialized in place at the start of the buffer.
+     * @param payload The payload data, copied right after the header.
+     * @param recipient The UDP endpoint of the recipient, which includes the IP address and port.
+     *
+     * @details
+     * - The send buffer is `thread_local` and only ever grows: once it reached the size of the
+     *   largest packet sent, sending does no heap allocation, and threads sending concurrently
+     *   never share it.
+     * - `send_to` is synchronous, so the buffer can be reused as soon as it returns.
+     * - In case of an error during the send operation, the method logs the error message.
+     * - A payload larger than `MAX_MESSAGE_SIZE` is logged and dropped.
+     *
+     * @see `GDTPHeader::toBuffer` for the header serialization.
      * @see `asio::buffer` for details on how data is wrapped for network operations.
      */
     void sendPacket(
-        const std::vector<uint8_t>& packet,
-        const std::string& recipient,
-        const int port
+        const GDTPHeader& header,
+        const std::vector<uint8_t>& payload,
+        const asio::ip::udp::endpoint& recipient
     ) {
-        if (!socket_.has_value()) {
-            throw std::runtime_error("Socket is not initialized");
+        if (payload.size() <= FRAGMENT_SIZE) {
+            sendDatagram(header, payload, recipient);
+            return;
         }
-        const asio::ip::udp::endpoint recipient_endpoint(asio::ip::address::from_string(recipient), port);
+        if (payload.size() > MAX_MESSAGE_SIZE) {
+            std::cout << "Failed to send packet: message of " << payload.size() << " bytes too large" << std::endl;
+            return;
+        }
+
+        GDTPHeader fragmentHeader = header;
+        fragmentHeader.totalPackets = static_cast<uint16_t>((payload.size() + FRAGMENT_SIZE - 1) / FRAGMENT_SIZE);
+        for (uint16_t i = 0; i < fragmentHeader.totalPackets; i++) {
+            const std::span<const uint8_t> fragment = std::span(payload).subspan(i * FRAGMENT_SIZE);
+            fragmentHeader.sequenceNumber = static_cast<uint16_t>(i + 1);
+            fragmentHeader.payloadSize = static_cast<uint16_t>(std::min(fragment.size(), FRAGMENT_SIZE));
+            sendDatagram(fragmentHeader, fragment.first(fragmentHeader.payloadSize), recipient);
+        }
+    }
+
+    /**
+     * @brief Sends a single datagram from the calling thread's send buffer, see `sendPacket()`.
+     */
+    void sendDatagram(
+        const GDTPHeader& header,
+        const std::span<const uint8_t> payload,
+        const asio::ip::udp::endpoint& recipient
+    ) {
+        asio::ip::udp::socket& socket = primarySocket();
+        thread_local std::vector<uint8_t> packet;
+        packet.resize(HEADER_SIZE + payload.size());
+        header.toBuffer(packet);
+        std::ranges::copy(payload, packet.begin() + HEADER_SIZE);
+
         std::error_code ec;
-        socket_->send_to(asio::buffer(packet), recipient_endpoint, 0, ec);
+        socket.send_to(asio::buffer(packet), recipient, 0, ec);
 
         if (ec) {
             std::cout << "Failed to send packet: " << ec.message() << std::endl;
@@ -640,11 +1463,10 @@ private:
      * It ensures that the received data is correctly formatted before delegating the message
      * to the `processMessage` function.
      *
-     * @param packet A `std::array<uint8_t, 1400>` containing the raw data received from the network.
-     *               This array represents the entire packet data, which includes both the header
+     * @param shard The socket the packet was received on, whose reassembler gets the fragments.
+     * @param packet A view of the raw data received from the network, in the receive buffer it
+     *               was written to. It spans the entire datagram, which includes both the header
      *               and the payload.
-     * @param length The size of the received packet in bytes (`std::size_t`). It indicates how many
-     *               bytes of valid data are present in the `packet` array.
      * @param client_endpoint An `asio::ip::udp::endpoint` representing the network address and port
      *                        of the client that sent the packet. It can be used to send responses
      *                        back to the client or to log the source of the packet.
@@ -652,13 +1474,16 @@ private:
      * @details
      * - This function begins by checking if the packet size is at least as large as the header size.
      *   If the packet is smaller than `HEADER_SIZE`, it logs an error and returns early.
-     * - It then converts the packet data into a `std::vector<uint8_t>` for easier handling and extracts
-     *   the header using the `GDTPHeader::fromBuffer` method.
+     * - It then parses the header in place with the `GDTPHeader::fromBuffer` method: the packet is
+     *   never copied, so processing a packet does no heap allocation.
      * - After parsing the header, it verifies that the packet contains the expected payload size.
      *   If the length of the packet is less than the header size plus the payload size, it logs an
      *   error indicating an incorrect payload size and returns.
-     * - Once the packet is validated, the payload is extracted from the vector, and the `processMessage`
+     * - Once the packet is validated, the payload is a view into the packet, and the `processMessage`
      *   function is called with the `header`, `payload`, and `client_endpoint`.
+     * - A fragment is instead added to the reassembler of the socket: the whole message is processed
+     *   once its last fragment arrives, with the header of that fragment, set back to one packet.
+     *   The fragments of a sender all arrive on the same socket, so reassembly needs no lock.
      *
      * @code
      * // Example usage in a NetworkingService class:
@@ -666,7 +1491,7 @@ private:
      * std::size_t packetLength = ...; // Length of data received
      * asio::ip::udp::endpoint senderEndpoint;
      *
-     * handleReceivedPacket(receivedPacket, packetLength, senderEndpoint);
+     * handleReceivedPacket(shard, std::span(receivedPacket).first(packetLength), senderEndpoint);
      * @endcode
      *
      * @warning This method assumes that `HEADER_SIZE` is a defined constant representing the size of the
@@ -679,24 +1504,36 @@ private:
      * @see `processMessage` for details on how the extracted message is processed.
      */
     void handleReceivedPacket(
-        const std::array<uint8_t, 1400>& packet,
-        const std::size_t length,
+        Shard& shard,
+        const std::span<const uint8_t> packet,
         const asio::ip::udp::endpoint& client_endpoint
     ) const {
+        const std::size_t length = packet.size();
         if (length < HEADER_SIZE) {
             std::cerr << "Received malformed packet: insufficient header size" << std::endl;
             return;
         }
 
-        std::vector packetData(packet.begin(), packet.begin() + length);
-        const GDTPHeader header = GDTPHeader::fromBuffer(packetData);
-        if (static_cast<uint16_t>(length) < HEADER_SIZE + header.payloadSize) {
+        const GDTPHeader header = GDTPHeader::fromBuffer(packet);
+        if (length < static_cast<std::size_t>(HEADER_SIZE) + header.payloadSize) {
             std::cerr << "Received malformed packet: incorrect payload size" << std::endl;
             return;
         }
 
-        const std::vector payload(packetData.begin() + HEADER_SIZE, packetData.begin() + HEADER_SIZE + header.payloadSize);
+        const std::span<const uint8_t> payload = packet.subspan(HEADER_SIZE, header.payloadSize);
 
+        if (header.totalPackets > 1) {
+            const auto message = shard.reassembler.add(client_endpoint, header, payload, Reassembler::Clock::now());
+            if (!message) {
+                return;
+            }
+            GDTPHeader messageHeader = header;
+            messageHeader.payloadSize = static_cast<uint16_t>(message->size());
+            messageHeader.sequenceNumber = 1;
+            messageHeader.totalPackets = 1;
+            processMessage(header.messageType, *message, messageHeader, client_endpoint);
+            return;
+        }
         processMessage(header.messageType, payload, header, client_endpoint);
     }
 
@@ -712,7 +1549,7 @@ private:
      * @param messageType The type of the received GDTP message as a `uint8_t`. This is used
      *                    to determine which handler to call. It corresponds to different
      *                    types of game events or protocol messages.
-     * @param payload A `std::vector<uint8_t>` containing the payload data of the message.
+     * @param payload A `std::span<const uint8_t>` viewing the payload data of the message in the receive buffer.
      *                This represents the actual data that was sent along with the message,
      *                such as player position, chat message, or other game-related information.
      * @param header The `GDTPHeader` of the received message. It contains metadata about the message,
@@ -723,7 +1560,9 @@ private:
      *                        which can be used for responding or tracking the sender.
      *
      * @details
-     * - The method first checks if a handler exists for the given `messageType` using the `message_handlers` map.
+     * - Envelopes are opened by `openEnvelope()`, which processes the messages they deliver.
+     * - Messages of a type set with `setStaticHandlers()` go to its generated dispatch.
+     * - Otherwise the handler is found by indexing the `message_handlers` table with `messageType`.
      * - If a handler is found, it calls the handler function, passing the `header`, `payload`,
      *   and `client_endpoint` as arguments. This allows the handler to process the data appropriately.
      * - If no handler is registered for the `messageType`, an error message is logged to `std::cerr`
@@ -731,16 +1570,16 @@ private:
      * - This method is typically used to decouple the reception of messages from their processing,
      *   allowing different message types to be handled by different functions or classes.
      *
-     * @note This method assumes that `message_handlers` is a `std::shared_ptr` to a map that
+     * @note This method assumes that `message_handlers` is a `std::shared_ptr` to a table that
      *       contains functions for handling various message types.
      *       Each function is expected to have a signature of
-     *       `void(const GDTPHeader&, const std::vector<uint8_t>&, const asio::ip::udp::endpoint&)`.
+     *       `void(const GDTPHeader&, std::span<const uint8_t>, const asio::ip::udp::endpoint&)`.
      *
      * @throws std::runtime_error If a handler is invoked and encounters an error internally.
      *
      * @code
      * // Example usage:
-     * std::vector<uint8_t> payload = ...; // Received payload data
+     * std::span<const uint8_t> payload = ...; // Received payload data
      * GDTPHeader header = ...; // Received header with metadata
      * asio::ip::udp::endpoint client_endpoint = ...; // Client's endpoint
      *
@@ -748,22 +1587,31 @@ private:
      * processMessage(0x01, payload, header, client_endpoint);
      * @endcode
      *
-     * @warning Ensure that the `message_handlers` map is properly initialized and contains handlers
+     * @warning Ensure that the `message_handlers` table is properly initialized and contains handlers
      *          for all expected message types to avoid missing important messages.
      *
      * @see GDTPHeader for more information about the header structure.
      */
     void processMessage(
         const uint8_t messageType,
-        const std::vector<uint8_t>& payload,
+        const std::span<const uint8_t> payload,
         const GDTPHeader& header,
         const asio::ip::udp::endpoint& client_endpoint
     ) const {
-        if (message_handlers->contains(messageType)  ) {
-            (*message_handlers)[messageType](header, payload, client_endpoint);
-        } else {
+        if (messageType == ENVELOPE_MESSAGE) {
+            openEnvelope(payload, header, client_endpoint);
+            return;
+        }
+        const HandlerTable& table = *message_handlers;
+        if (table.staticDispatch && table.staticDispatch(table.staticHandler.get(), messageType, header, payload, client_endpoint)) {
+            return;
+        }
+        const MessageHandler& handler = table.handlers[messageType];
+        if (!handler) {
             std::cerr << "No handler found for message type: " << static_cast<int>(messageType) << std::endl;
+            return;
         }
+        handler(header, payload, client_endpoint);
     }
 
 };
@@ -0,0 +1,125 @@
+#ifndef REASSEMBLER_HPP_
+#define REASSEMBLER_HPP_
+
+/**
+ * @file Reassembler.hpp
+ * @brief Reassembly of the messages sent in several GDTP packets.
+ */
+
+#include <algorithm>
+#include <array>
+#include <asio.hpp>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include "./includes/RequestHeader.hpp"
+
+/**
+ * @class Reassembler
+ * @brief Puts the fragments of messages back together, in a fixed number of reusable buffers.
+ *
+ * A message too large for a datagram is split in fragments of `fragmentSize` bytes, the last one
+ * shorter, sent in packets sharing its packet id and type: `sequenceNumber` is the position of the
+ * fragment, from 1, and `totalPackets` the number of fragments. The fragments may arrive in any order.
+ *
+ * At most `SLOTS` messages are reassembled at once per instance. A message still incomplete after
+ * `TIMEOUT` gives its slot up to the next message that needs one, and when every slot is busy the
+ * oldest message is dropped: memory stays bounded whatever a sender does. The buffers of the slots
+ * keep their capacity from one message to the next. The instance is not thread-safe.
+ */
+class Reassembler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t SLOTS = 16;           ///< Messages reassembled at once.
+    static constexpr std::size_t MAX_FRAGMENTS = 64;   ///< Fragments of a message at most.
+    static constexpr std::size_t MAX_SIZE = UINT16_MAX; ///< Largest message, whose size fits the `payloadSize` of a header.
+    static constexpr Clock::duration TIMEOUT = std::chrono::seconds(1); ///< Time for a message to complete.
+
+    /**
+     * @param fragmentSize Size of every fragment but the last one of a message.
+     */
+    explicit Reassembler(const std::size_t fragmentSize) : _fragmentSize(fragmentSize) {}
+
+    /**
+     * @brief Adds a fragment of a message.
+     *
+     * Malformed fragments, duplicates and fragments of a message whose slot was reused are ignored.
+     *
+     * @return The payload of the whole message once its last missing fragment is added, valid until the next call.
+     */
+    std::optional<std::span<const uint8_t>> add(
+        const asio::ip::udp::endpoint &sender, const GDTPHeader &header, const std::span<const uint8_t> fragment,
+        const Clock::time_point now)
+    {
+        const std::size_t total = header.totalPackets;
+        const std::size_t index = header.sequenceNumber - 1;
+        if (total < 2 || total > MAX_FRAGMENTS || header.sequenceNumber == 0 || index >= total)
+            return std::nullopt;
+        const bool last = index == total - 1;
+        if (last ? fragment.empty() || fragment.size() > _fragmentSize : fragment.size() != _fragmentSize)
+            return std::nullopt;
+        if (index * _fragmentSize + fragment.size() > MAX_SIZE)
+            return std::nullopt;
+
+        Slot &slot = find(sender, header, now);
+        if (slot.total != total || slot.messageType != header.messageType || slot.received[index])
+            return std::nullopt;
+        slot.received[index] = true;
+        std::ranges::copy(fragment, slot.buffer.begin() + static_cast<std::ptrdiff_t>(index * _fragmentSize));
+        if (last)
+            slot.size = index * _fragmentSize + fragment.size();
+        if (slot.received.count() != total)
+            return std::nullopt;
+
+        slot.active = false;
+        return std::span<const uint8_t>(slot.buffer).first(slot.size);
+    }
+
+private:
+    struct Slot {
+        bool active = false;
+        asio::ip::udp::endpoint sender;
+        uint64_t packetId = 0;
+        uint8_t messageType = 0;
+        std::size_t total = 0;
+        std::size_t size = 0;
+        std::bitset<MAX_FRAGMENTS> received;
+        Clock::time_point started;
+        std::vector<uint8_t> buffer;
+    };
+
+    // The slot of the message, or a free one: unused, expired, or else the oldest
+    Slot &find(const asio::ip::udp::endpoint &sender, const GDTPHeader &header, const Clock::time_point now)
+    {
+        const auto rank = [&](const Slot &slot) {
+            return !slot.active ? 0 : now - slot.started > TIMEOUT ? 1 : 2;
+        };
+        Slot *free = nullptr;
+        for (Slot &slot : _slots) {
+            if (rank(slot) == 2 && slot.packetId == header.packetId && slot.sender == sender)
+                return slot;
+            if (!free || rank(slot) < rank(*free) || (rank(slot) == rank(*free) && slot.started < free->started))
+                free = &slot;
+        }
+
+        free->active = true;
+        free->sender = sender;
+        free->packetId = header.packetId;
+        free->messageType = header.messageType;
+        free->total = header.totalPackets;
+        free->size = 0;
+        free->received.reset();
+        free->started = now;
+        free->buffer.resize(free->total * _fragmentSize);
+        return *free;
+    }
+
+    std::size_t _fragmentSize;
+    std::array<Slot, SLOTS> _slots;
+};
+
+#endif // REASSEMBLER_HPP_
@@ -15,6 +15,7 @@
 #ifndef REQUESTHEADER_HPP
     #define REQUESTHEADER_HPP
     #include <cstdint>
+    #include <span>
     #include <vector>
     #include <cstring>
     #define HEADER_SIZE 16
@@ -123,8 +124,25 @@ struct GDTPHeader {
    * @endcode
    */
   std::vector<uint8_t> toBuffer() const {
-    std::vector<uint8_t> buffer(16);  // 16 bytes for the header (with sequence number and total packets)
+    std::vector<uint8_t> buffer(HEADER_SIZE);  // 16 bytes for the header (with sequence number and total packets)
 
+    toBuffer(buffer);
+    return buffer;
+  }
+
+  /**
+   * @brief Serializes the GDTPHeader structure in place, at the start of an existing buffer.
+   *
+   * Used to write the header right before the payload in the buffer of an outgoing packet,
+   * without allocating a buffer for the header alone.
+   *
+   * @param buffer The buffer to write to; only its first 16 bytes are written.
+   * @throws HeaderSizeError If the buffer is shorter than 16 bytes.
+   */
+  void toBuffer(const std::span<uint8_t> buffer) const {
+    if (buffer.size() < HEADER_SIZE) {
+      throw HeaderSizeError();
+    }
     buffer[0] = version;
     buffer[1] = messageType;
 
@@ -142,8 +160,6 @@ struct GDTPHeader {
 
     uint16_t totalPacketsNetworkOrder = htons(totalPackets);
     std::memcpy(&buffer[14], &totalPacketsNetworkOrder, 2);
-
-    return buffer;
   }
 
   /**
@@ -152,7 +168,7 @@ struct GDTPHeader {
    * This function deserializes a buffer of bytes into a GDTPHeader structure, converting
    * multi-byte fields (packetId, payloadSize, sequenceNumber, totalPackets) from network byte order to host byte order.
    *
-   * @param buffer A vector of bytes representing the received header.
+   * @param buffer A view of the received bytes, read in place; only the first 16 bytes are used.
    * @return A GDTPHeader structure populated with the values from the buffer.
    *
    * @note The input buffer must be at least 16 bytes long to contain a valid header.
@@ -162,7 +178,7 @@ struct GDTPHeader {
    * GDTPHeader header = GDTPHeader::fromBuffer(buffer);
    * @endcode
    */
-  static GDTPHeader fromBuffer(const std::vector<uint8_t>& buffer) {
+  static GDTPHeader fromBuffer(const std::span<const uint8_t> buffer) {
 
     if (buffer.size() < HEADER_SIZE) {
       throw HeaderSizeError();
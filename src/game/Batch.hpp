@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../core/network/NetworkService.hpp"
+
+/**
+ * @namespace batch
+ * @brief Coalescing of several messages for one destination into a single datagram.
+ *
+ * A Batch payload is a sequence of sub-messages, each framed as:
+ * message type (1 byte), payload length (unsigned varint), payload.
+ * Receivers handle every sub-message as if it had arrived in its own datagram.
+ */
+namespace batch {
+    /**
+     * @brief Largest payload that fits a datagram unfragmented: the receive buffer less the GDTP header.
+     */
+    constexpr size_t MAX_PAYLOAD = NetworkingService::FRAGMENT_SIZE;
+
+    inline size_t varintSize(size_t value)
+    {
+        size_t size = 1;
+        for (; value >= 0x80; value >>= 7)
+            ++size;
+        return size;
+    }
+
+    /**
+     * @brief Size a message takes once framed in a batch.
+     */
+    inline size_t framedSize(const size_t payloadSize)
+    {
+        return 1 + varintSize(payloadSize) + payloadSize;
+    }
+
+    inline void append(std::vector<std::uint8_t> &out, const std::uint8_t messageType, const std::vector<std::uint8_t> &payload)
+    {
+        out.push_back(messageType);
+        for (size_t size = payload.size(); ; size >>= 7) {
+            if (size < 0x80) {
+                out.push_back(static_cast<std::uint8_t>(size));
+                break;
+            }
+            out.push_back(static_cast<std::uint8_t>(size | 0x80));
+        }
+        out.insert(out.end(), payload.begin(), payload.end());
+    }
+
+    /**
+     * @brief Calls @p handler with the type and payload of every sub-message, in order.
+     *
+     * Sub-message payloads are views into @p payload, nothing is copied.
+     * @return false if the batch is malformed; the sub-messages before the error have been handled.
+     */
+    template <typename Handler>
+    bool forEach(const std::span<const std::uint8_t> payload, Handler &&handler)
+    {
+        size_t offset = 0;
+        while (offset < payload.size()) {
+            const std::uint8_t messageType = payload[offset++];
+
+            size_t size = 0;
+            for (unsigned shift = 0; ; shift += 7) {
+                if (offset >= payload.size() || shift > 14)
+                    return false;
+                const std::uint8_t byte = payload[offset++];
+                size |= static_cast<size_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    break;
+            }
+            if (size > payload.size() - offset)
+                return false;
+
+            handler(messageType, payload.subspan(offset, size));
+            offset += size;
+        }
+        return true;
+    }
+}
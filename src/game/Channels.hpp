@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../core/network/NetworkService.hpp"
+#include "RequestType.hpp"
+
+/**
+ * @brief Channel of each message type, the same on the client and the server.
+ *
+ * Messages whose loss desyncs a client for good are reliable. Continuous state, sent again
+ * and again anyway, stays unreliable: a retransmission would only arrive after fresher data.
+ */
+namespace channels {
+    inline void configure(const NetworkingService &networkingService)
+    {
+        for (const RequestType type : {
+                 PlayerConnect, PlayerDisconnect, GameStart, GameOver, TileDestroy,
+                 PlayerProjectileShoot, PlayerProjectileCreate, PlayerProjectileDestroy,
+                 PlayerMissileShoot, PlayerMissileCreate, PlayerMissileDestroy,
+                 PlayerHit, PlayerDie, EnemySpawn, EnemyDie})
+            networkingService.setChannel(type, Channel::ReliableOrdered);
+
+        // Only the latest scroll position matters
+        networkingService.setChannel(MapScroll, Channel::UnreliableSequenced);
+    }
+}
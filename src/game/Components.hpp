@@ -104,7 +104,7 @@ struct PlayerAnim {
  * This tag is applied to enemy entities to distinguish them in systems or logic that targets enemies.
  */
 struct Enemy {
-    std::uint8_t id = 0;
+    std::uint16_t id = 0;
 };
 
 /**
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Player movement rules shared by the client and the server.
+ *
+ * Clients only send the state of their movement keys, packed as bits, at a fixed rate and
+ * the server moves the players itself, each input for one input interval: both sides derive
+ * the velocity from the same bits so the client can predict where the server will put it.
+ */
+namespace movement {
+    enum InputBit : std::uint8_t {
+        Up = 1 << 0,
+        Down = 1 << 1,
+        Left = 1 << 2,
+        Right = 1 << 3,
+    };
+
+    // Inputs sent per second, each one moving its player for the inverse of it
+    constexpr float DEFAULT_INPUT_RATE = 30.0f;
+
+    // Player id, big endian sequence number, input bits
+    constexpr std::size_t INPUT_PAYLOAD_SIZE = 6;
+
+    inline std::uint8_t pack(const bool up, const bool down, const bool left, const bool right)
+    {
+        return static_cast<std::uint8_t>((up ? Up : 0) | (down ? Down : 0) | (left ? Left : 0) | (right ? Right : 0));
+    }
+
+    inline sf::Vector2f velocity(const std::uint8_t input, const sf::Vector2f speed)
+    {
+        return {
+            speed.x * static_cast<float>(((input & Right) != 0) - ((input & Left) != 0)),
+            speed.y * static_cast<float>(((input & Down) != 0) - ((input & Up) != 0))
+        };
+    }
+
+    /**
+     * @brief Whether an input sequence number comes after another one.
+     *
+     * Datagrams can arrive out of order: an older input must not override a newer one.
+     * The comparison holds across the wrap around of the counter.
+     */
+    inline bool isNewer(const std::uint32_t sequence, const std::uint32_t last)
+    {
+        return static_cast<std::int32_t>(sequence - last) > 0;
+    }
+}
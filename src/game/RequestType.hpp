@@ -22,4 +22,9 @@ enum RequestType: uint8_t {
     EnemySpawn = 16,
     EnemyMove = 17,
     EnemyDie = 18,
+    Snapshot = 19,
+    SnapshotAck = 20,
+    Batch = 21,
+    PlayerInput = 22,
+    Envelope = 255, // Reserved by NetworkingService, carries the messages of the sequenced and reliable channels
 };
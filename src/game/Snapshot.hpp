@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+/**
+ * @enum ReplicatedKind
+ * @brief Kind of a replicated entity, stored above the per-kind id in its network id.
+ */
+enum class ReplicatedKind : std::uint8_t {
+    Player = 0,
+    Enemy = 1,
+    Projectile = 2,
+    Missile = 3,
+};
+
+/**
+ * @struct ReplicatedEntity
+ * @brief Replicated state of one entity in a world snapshot.
+ *
+ * Entities moving in straight lines are dead reckoned: the position is the one they had at @ref tick and
+ * the receiver extrapolates it with the velocity. The server only changes that state when the entity
+ * strays from the extrapolated path, so a straight-line mover costs nothing after its creation.
+ */
+struct ReplicatedEntity {
+    std::uint32_t netId = 0; ///< Network id: the kind above the 16-bit per-kind id.
+    std::uint8_t type = 0;   ///< Kind-specific variant (e.g. the enemy type), only sent when the entity is created.
+    std::int32_t x = 0;      ///< Position on the x axis at @ref tick, in whole pixels.
+    std::int32_t y = 0;      ///< Position on the y axis at @ref tick, in whole pixels.
+    std::int16_t vx = 0;     ///< Velocity on the x axis, in pixels per second.
+    std::int16_t vy = 0;     ///< Velocity on the y axis, in pixels per second.
+    std::uint32_t tick = 0;  ///< Server tick the position was taken at, 0 for an entity that is not extrapolated.
+
+    static std::uint32_t makeId(ReplicatedKind kind, const std::uint16_t id)
+    {
+        return static_cast<std::uint32_t>(static_cast<std::uint8_t>(kind)) << 16 | id;
+    }
+
+    [[nodiscard]] ReplicatedKind kind() const { return static_cast<ReplicatedKind>(netId >> 16); }
+    [[nodiscard]] std::uint16_t id() const { return static_cast<std::uint16_t>(netId & 0xFFFF); }
+
+    bool operator==(const ReplicatedEntity &) const = default;
+
+    /**
+     * @brief Extrapolates the position to a server tick.
+     * @param at The tick to extrapolate to.
+     * @param tickDuration The duration of a server tick, in seconds.
+     * @return The position on the x and y axes, in pixels.
+     */
+    [[nodiscard]] std::pair<float, float> positionAt(const std::uint32_t at, const float tickDuration) const
+    {
+        const float elapsed = tick ? static_cast<float>(static_cast<std::int32_t>(at - tick)) * tickDuration : 0.0f;
+        return {static_cast<float>(x) + static_cast<float>(vx) * elapsed, static_cast<float>(y) + static_cast<float>(vy) * elapsed};
+    }
+};
+
+/**
+ * @struct WorldSnapshot
+ * @brief Replicated state of the world at a given server tick.
+ *
+ * A snapshot with tick 0 is the empty baseline: a delta against it is a full snapshot.
+ */
+struct WorldSnapshot {
+    std::uint32_t tick = 0;                 ///< Server tick the snapshot was captured at.
+    std::vector<ReplicatedEntity> entities; ///< Replicated entities, sorted by network id.
+    std::uint32_t inputSequence = 0;        ///< Last input of the receiving client applied at that tick, 0 if none.
+    std::uint32_t tickDuration = 0;         ///< Duration of a server tick, in microseconds, to extrapolate with.
+
+    /**
+     * @brief Gets the duration of a server tick, in seconds.
+     */
+    [[nodiscard]] float tickSeconds() const { return static_cast<float>(tickDuration) / 1e6f; }
+
+    void sort()
+    {
+        std::ranges::sort(entities, {}, &ReplicatedEntity::netId);
+    }
+
+    [[nodiscard]] const ReplicatedEntity *find(const std::uint32_t netId) const
+    {
+        const auto it = std::ranges::lower_bound(entities, netId, {}, &ReplicatedEntity::netId);
+        return it != entities.end() && it->netId == netId ? &*it : nullptr;
+    }
+};
+
+/**
+ * @namespace snapshot
+ * @brief Delta encoding of world snapshots.
+ *
+ * Payload layout (big endian):
+ * - tick (4 bytes), base tick (4 bytes, 0 for a full snapshot), input sequence of the receiver (4 bytes),
+ *   tick duration in microseconds (4 bytes);
+ * - updated entity count (2 bytes), then per entity: network id (3 bytes, the kind then the id), flags (1 byte),
+ *   type (1 byte, if created), zigzag varint x and y deltas against the base (if changed),
+ *   zigzag varint x and y velocities (if changed), varint age of the position in ticks (if changed);
+ * - removed entity count (2 bytes), then their network ids (3 bytes each).
+ */
+namespace snapshot {
+    enum Flags : std::uint8_t {
+        Created = 1 << 0,
+        ChangedX = 1 << 1,
+        ChangedY = 1 << 2,
+        ChangedVelocity = 1 << 3,
+        ChangedTick = 1 << 4,
+    };
+
+    namespace detail {
+        inline void writeU16(std::vector<std::uint8_t> &out, const std::uint16_t value)
+        {
+            out.push_back(static_cast<std::uint8_t>(value >> 8));
+            out.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        inline void writeU32(std::vector<std::uint8_t> &out, const std::uint32_t value)
+        {
+            writeU16(out, static_cast<std::uint16_t>(value >> 16));
+            writeU16(out, static_cast<std::uint16_t>(value));
+        }
+
+        inline void writeNetId(std::vector<std::uint8_t> &out, const std::uint32_t netId)
+        {
+            out.push_back(static_cast<std::uint8_t>(netId >> 16));
+            writeU16(out, static_cast<std::uint16_t>(netId));
+        }
+
+        inline void writeVarint(std::vector<std::uint8_t> &out, const std::int32_t value)
+        {
+            auto zigzag = static_cast<std::uint32_t>(value) << 1 ^ static_cast<std::uint32_t>(value >> 31);
+            while (zigzag >= 0x80) {
+                out.push_back(static_cast<std::uint8_t>(zigzag | 0x80));
+                zigzag >>= 7;
+            }
+            out.push_back(static_cast<std::uint8_t>(zigzag));
+        }
+
+        /**
+         * @brief Difference and sum of positions with two's complement wrapping, so any delta round-trips.
+         */
+        inline std::int32_t wrappingSub(const std::int32_t a, const std::int32_t b)
+        {
+            return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) - static_cast<std::uint32_t>(b));
+        }
+
+        inline std::int32_t wrappingAdd(const std::int32_t a, const std::int32_t b)
+        {
+            return static_cast<std::int32_t>(static_cast<std::uint32_t>(a) + static_cast<std::uint32_t>(b));
+        }
+
+        /**
+         * @brief Bounds-checked reader over a payload; every read fails once the payload is exhausted.
+         */
+        struct Reader {
+            const std::vector<std::uint8_t> &data;
+            size_t offset = 0;
+
+            std::optional<std::uint8_t> u8()
+            {
+                if (offset >= data.size())
+                    return std::nullopt;
+                return data[offset++];
+            }
+
+            std::optional<std::uint16_t> u16()
+            {
+                if (offset + 2 > data.size())
+                    return std::nullopt;
+                const auto value = static_cast<std::uint16_t>(data[offset] << 8 | data[offset + 1]);
+                offset += 2;
+                return value;
+            }
+
+            std::optional<std::uint32_t> u32()
+            {
+                const auto high = u16();
+                const auto low = u16();
+                if (!high || !low)
+                    return std::nullopt;
+                return static_cast<std::uint32_t>(*high) << 16 | *low;
+            }
+
+            std::optional<std::uint32_t> netId()
+            {
+                const auto kind = u8();
+                const auto id = u16();
+                if (!kind || !id)
+                    return std::nullopt;
+                return static_cast<std::uint32_t>(*kind) << 16 | *id;
+            }
+
+            std::optional<std::int32_t> varint()
+            {
+                std::uint32_t zigzag = 0;
+                for (unsigned shift = 0; shift < 35; shift += 7) {
+                    const auto byte = u8();
+                    if (!byte)
+                        return std::nullopt;
+                    zigzag |= static_cast<std::uint32_t>(*byte & 0x7F) << shift;
+                    if (!(*byte & 0x80))
+                        return static_cast<std::int32_t>(zigzag >> 1 ^ (~(zigzag & 1) + 1));
+                }
+                return std::nullopt;
+            }
+        };
+    }
+
+    /**
+     * @brief Encodes @p current as a delta against @p base, which the receiver must already hold.
+     * @param inputSequence The last input of the receiver the server applied, sent whole in every snapshot.
+     */
+    inline std::vector<std::uint8_t> encode(const WorldSnapshot &base, const WorldSnapshot &current, const std::uint32_t inputSequence = 0)
+    {
+        std::vector<std::uint8_t> out;
+        detail::writeU32(out, current.tick);
+        detail::writeU32(out, base.tick);
+        detail::writeU32(out, inputSequence);
+        detail::writeU32(out, current.tickDuration);
+
+        const size_t updatedCountOffset = out.size();
+        std::uint16_t updated = 0;
+        detail::writeU16(out, 0);
+
+        static constexpr ReplicatedEntity none{};
+        std::vector<std::uint32_t> removed;
+        auto previous = base.entities.begin();
+        for (const auto &entity : current.entities) {
+            for (; previous != base.entities.end() && previous->netId < entity.netId; ++previous)
+                removed.push_back(previous->netId);
+
+            const ReplicatedEntity *old = previous != base.entities.end() && previous->netId == entity.netId ? &*previous : nullptr;
+            if (old)
+                ++previous;
+            // A recycled id with another type is a new entity for the receiver.
+            if (old && old->type != entity.type)
+                old = nullptr;
+
+            const ReplicatedEntity &previousState = old ? *old : none;
+            std::uint8_t flags = old ? 0 : Created | ChangedX | ChangedY;
+            if (entity.x != previousState.x)
+                flags |= ChangedX;
+            if (entity.y != previousState.y)
+                flags |= ChangedY;
+            if (entity.vx != previousState.vx || entity.vy != previousState.vy)
+                flags |= ChangedVelocity;
+            if (entity.tick != previousState.tick)
+                flags |= ChangedTick;
+            if (!flags)
+                continue;
+
+            detail::writeNetId(out, entity.netId);
+            out.push_back(flags);
+            if (flags & Created)
+                out.push_back(entity.type);
+            if (flags & ChangedX)
+                detail::writeVarint(out, detail::wrappingSub(entity.x, previousState.x));
+            if (flags & ChangedY)
+                detail::writeVarint(out, detail::wrappingSub(entity.y, previousState.y));
+            if (flags & ChangedVelocity) {
+                detail::writeVarint(out, entity.vx);
+                detail::writeVarint(out, entity.vy);
+            }
+            // The age is small where the tick itself is not, 0 stands for "not extrapolated"
+            if (flags & ChangedTick)
+                detail::writeVarint(out, entity.tick ? static_cast<std::int32_t>(current.tick - entity.tick) + 1 : 0);
+            ++updated;
+        }
+        for (; previous != base.entities.end(); ++previous)
+            removed.push_back(previous->netId);
+
+        out[updatedCountOffset] = static_cast<std::uint8_t>(updated >> 8);
+        out[updatedCountOffset + 1] = static_cast<std::uint8_t>(updated);
+
+        detail::writeU16(out, static_cast<std::uint16_t>(removed.size()));
+        for (const auto netId : removed)
+            detail::writeNetId(out, netId);
+        return out;
+    }
+
+    /**
+     * @brief Reads the tick a delta was encoded against, so the receiver can look its base up.
+     */
+    inline std::optional<std::uint32_t> baseTick(const std::vector<std::uint8_t> &payload)
+    {
+        detail::Reader reader{payload, 4};
+        return reader.u32();
+    }
+
+    /**
+     * @brief Rebuilds the snapshot encoded in @p payload on top of @p base.
+     * @return The snapshot, or std::nullopt if the payload is malformed or was not encoded against @p base.
+     */
+    inline std::optional<WorldSnapshot> decode(const WorldSnapshot &base, const std::vector<std::uint8_t> &payload)
+    {
+        detail::Reader reader{payload};
+        const auto tick = reader.u32();
+        const auto encodedBase = reader.u32();
+        const auto inputSequence = reader.u32();
+        const auto tickDuration = reader.u32();
+        const auto updated = reader.u16();
+        if (!tick || !encodedBase || !inputSequence || !tickDuration || !updated || *encodedBase != base.tick)
+            return std::nullopt;
+
+        std::map<std::uint32_t, ReplicatedEntity> entities;
+        for (const auto &entity : base.entities)
+            entities.emplace(entity.netId, entity);
+
+        for (std::uint16_t i = 0; i < *updated; ++i) {
+            const auto netId = reader.netId();
+            const auto flags = reader.u8();
+            if (!netId || !flags)
+                return std::nullopt;
+
+            auto it = entities.find(*netId);
+            if (*flags & Created) {
+                const auto type = reader.u8();
+                if (!type)
+                    return std::nullopt;
+                it = entities.insert_or_assign(*netId, ReplicatedEntity{*netId, *type}).first;
+            } else if (it == entities.end())
+                return std::nullopt;
+
+            if (*flags & ChangedX) {
+                const auto dx = reader.varint();
+                if (!dx)
+                    return std::nullopt;
+                it->second.x = detail::wrappingAdd(it->second.x, *dx);
+            }
+            if (*flags & ChangedY) {
+                const auto dy = reader.varint();
+                if (!dy)
+                    return std::nullopt;
+                it->second.y = detail::wrappingAdd(it->second.y, *dy);
+            }
+            if (*flags & ChangedVelocity) {
+                const auto vx = reader.varint();
+                const auto vy = reader.varint();
+                if (!vx || !vy)
+                    return std::nullopt;
+                it->second.vx = static_cast<std::int16_t>(*vx);
+                it->second.vy = static_cast<std::int16_t>(*vy);
+            }
+            if (*flags & ChangedTick) {
+                const auto age = reader.varint();
+                if (!age)
+                    return std::nullopt;
+                it->second.tick = *age ? *tick - static_cast<std::uint32_t>(*age - 1) : 0;
+            }
+        }
+
+        const auto removed = reader.u16();
+        if (!removed)
+            return std::nullopt;
+        for (std::uint16_t i = 0; i < *removed; ++i) {
+            const auto netId = reader.netId();
+            if (!netId)
+                return std::nullopt;
+            entities.erase(*netId);
+        }
+        if (reader.offset != payload.size())
+            return std::nullopt;
+
+        WorldSnapshot snapshot{*tick, {}, *inputSequence, *tickDuration};
+        snapshot.entities.reserve(entities.size());
+        for (const auto &entity : entities | std::views::values)
+            snapshot.entities.push_back(entity);
+        return snapshot;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef COMMAND_HPP
+#define COMMAND_HPP
+
+#include <cstdint>
+
+#include "../../../core/network/NetworkService.hpp"
+
+enum class CommandType : uint8_t {
+    Connect,
+    Disconnect,
+    Kick,
+    Start,
+    Input,
+    ShootProjectile,
+    ShootMissile,
+    AckSnapshot,
+};
+
+// Decoded client message, queued by the network thread for the worker running the room
+struct Command {
+    CommandType type = CommandType::Start;
+    uint8_t player = 0;                 // Player slot the command is about
+    uint8_t input = 0;                  // Movement input bits
+    uint32_t sequence = 0;              // Input sequence number
+    uint32_t tick = 0;                  // Acknowledged snapshot tick
+    asio::ip::udp::endpoint endpoint{}; // Sender, answered on Connect and matched against the player otherwise
+    GDTPHeader header{};                // Connect request answered
+};
+
+#endif //COMMAND_HPP
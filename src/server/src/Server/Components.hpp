@@ -2,6 +2,7 @@
     #define COMPONENTS_HPP
 
 #include "../../../core/network/NetworkService.hpp"
+#include "../../../game/Snapshot.hpp"
 
 struct Network {
     NetworkingService &service;
@@ -20,16 +21,29 @@ struct Player {
     uint8_t id;
     uint8_t health;
     time_t lastTimePacketReceived;
+    uint32_t inputSequence = 0; // Last input applied, acknowledged in snapshots
+    float inputBudget = 0;      // Seconds of movement the player may still apply inputs for
+    bool moving = false;        // Whether the last input applied moved the player
 };
 
 struct Enemy {
-    uint8_t id;
+    uint16_t id;
+    uint8_t type;
 };
 
 struct Projectile {
-    uint8_t id;
+    uint16_t id;
+};
+
+struct Missile {
+    uint16_t id;
 };
 
 struct Tile {};
 
+// Motion last replicated for a moving entity, which clients extrapolate until the server corrects it
+struct DeadReckoning {
+    ReplicatedEntity motion;
+};
+
 #endif //COMPONENTS_HPP
@@ -6,18 +6,18 @@
 #include <utility>
 
 #include "Components.hpp"
-#include "Server.hpp"
+#include "Room.hpp"
 #include "../../../game/CollisionMask.hpp"
 #include "../../../core/ecs/GameEngine/GameEngineComponents.hpp"
 #include "../../../game/RequestType.hpp"
 
 core::ecs::Entity EntityFactory::createWorld(
-    Server &server,
+    Room &room,
     const std::string& filePath)
 {
-    auto &gameEngine = server.getGameEngine();
-    auto &networkingService = server.getNetworkingService();
-    auto &config = server.getConfigManager();
+    auto &gameEngine = room.getGameEngine();
+    auto &networkingService = room.getNetworkingService();
+    auto &config = room.getConfigManager();
 
     const core::ecs::Entity world = gameEngine.registry.spawn_entity();
 
@@ -44,6 +44,7 @@ core::ecs::Entity EntityFactory::createWorld(
     World worldComponent = {
         std::time(nullptr), 1,
         { size.x, size.y }, json["cellSize"], {}};
+    std::vector solidTiles(json["height"].get<size_t>(), std::vector(json["width"].get<size_t>(), false));
     for (const auto& tile : json["tiles"]) {
         if (tile.contains("tags")) {
             if (std::vector<std::string> tags = tile["tags"]; tags.end() == std::ranges::find(tags, "spawn"))
@@ -55,34 +56,64 @@ core::ecs::Entity EntityFactory::createWorld(
             continue;
         }
 
-        if (tile["x"] < 0 || tile["x"] >= worldComponent.size.first
-            || tile["y"] < 0 || tile["y"] >= worldComponent.size.second) {
+        if (tile["x"] < 0 || tile["x"] >= solidTiles.front().size()
+            || tile["y"] < 0 || tile["y"] >= solidTiles.size()) {
             throw std::out_of_range("Tile coordinates out of bounds");
         }
 
         const uint32_t x = tile["x"];
         const uint32_t y = tile["y"];
-        createTile(server, {worldComponent.tileSize, worldComponent.tileSize}, x * worldComponent.tileSize, y * worldComponent.tileSize);
+        if (tile.value("isDestructible", false))
+            createTile(room, {worldComponent.tileSize, worldComponent.tileSize}, x, y);
+        else
+            solidTiles[y][x] = true;
     }
+    createStaticTiles(room, solidTiles, worldComponent.tileSize);
     gameEngine.registry.add_component(world, std::move(worldComponent));
 
     return world;
 }
 
+core::ecs::Entity EntityFactory::createStaticTiles(
+    Room &room,
+    const std::vector<std::vector<bool>> &solidTiles,
+    const uint32_t tileSize)
+{
+    core::GameEngine &gameEngine = room.getGameEngine();
+
+    std::vector<sf::FloatRect> rects;
+    for (const auto &rect : core::ge::mergeCells(solidTiles)) {
+        rects.emplace_back(
+            static_cast<float>(rect.left * tileSize),
+            static_cast<float>(rect.top * tileSize),
+            static_cast<float>(rect.width * tileSize),
+            static_cast<float>(rect.height * tileSize));
+    }
+    const auto bvh = std::make_shared<const core::ge::StaticBVH>(std::move(rects));
+
+    const core::ecs::Entity tiles = gameEngine.registry.spawn_entity();
+
+    gameEngine.registry.add_component(tiles, core::ge::TransformComponent{sf::Vector2f(0, 0), sf::Vector2f(bvh->bounds().width, bvh->bounds().height), sf::Vector2f(1, 1), 0});
+    gameEngine.registry.add_component(tiles, core::ge::CollisionComponent{TILE, {bvh->bounds()}, {}, bvh});
+
+    *gameEngine.out << "Static tiles merged into " << bvh->rects().size() << " colliders" << std::endl;
+    return tiles;
+}
+
 core::ecs::Entity EntityFactory::createPlayer(
-    Server &server,
+    Room &room,
     const uint8_t id)
 {
-    auto &gameEngine = server.getGameEngine();
-    auto &networkingService = server.getNetworkingService();
-    const auto &config = server.getConfigManager();
-    const auto &playersConnection = server.getPlayersConnection();
-    auto &players = server.getPlayers();
+    auto &gameEngine = room.getGameEngine();
+    auto &networkingService = room.getNetworkingService();
+    const auto &config = room.getConfigManager();
+    const auto &playersConnection = room.getPlayersConnection();
+    auto &players = room.getPlayers();
 
     const core::ecs::Entity world = gameEngine.registry.get_entities<World>()[0];
     const auto &worldComponent = gameEngine.registry.get_component<World>(world);
 
-    const std::function onCollision = [&, id](const core::ecs::Entity& entity, const core::ecs::Entity& otherEntity) {
+    const std::function onCollision = [&, id](const core::ecs::Entity& entity, const core::ecs::Entity&) {
         *gameEngine.out << "Player " << static_cast<int>(id) << " collided" << std::endl;
 
         RequestType requestType = PlayerHit;
@@ -93,22 +124,20 @@ core::ecs::Entity EntityFactory::createPlayer(
                 requestType = PlayerDie;
         }
 
-        server.sendRequestToPlayers(requestType, {id});
+        room.sendRequestToPlayers(requestType, {id});
 
         if (requestType == PlayerDie) {
             *gameEngine.out << "Player " << static_cast<int>(id) << " died" << std::endl;
 
-            gameEngine.run_collision(PLAYER, otherEntity);
-
             players[id].reset();
-            gameEngine.registry.kill_entity(entity);
+            gameEngine.defer_kill(entity);
         }
 
         if (std::ranges::none_of(gameEngine.registry.get_entities<Player>(), [&](const auto &playerEntity) {
             const auto &playerComponent = gameEngine.registry.get_component<Player>(playerEntity);
             return playerComponent->health > 0;
         })) {
-            server.sendRequestToPlayers(GameOver, {});
+            room.sendRequestToPlayers(GameOver, {});
         }
     };
 
@@ -137,11 +166,12 @@ core::ecs::Entity EntityFactory::createPlayer(
             else if (playerTransformComponent->position.x + playerTransformComponent->size.x > worldTransformComponent->position.x + worldTransformComponent->size.x)
                 playerTransformComponent->position.x = worldTransformComponent->position.x + worldTransformComponent->size.x - playerTransformComponent->size.x;
 
-            {
+            // The clamped position reaches the clients in snapshots, and the local player reconciles with it
+            if (!room.isSnapshotReplication()) {
                 const auto x = static_cast<uint32_t>(playerTransformComponent->position.x);
                 const auto y = static_cast<uint32_t>(playerTransformComponent->position.y);
 
-                server.sendRequestToPlayers(
+                room.sendRequestToPlayers(
                     PlayerMove,
                     {
                         static_cast<uint8_t>(id),
@@ -158,7 +188,7 @@ core::ecs::Entity EntityFactory::createPlayer(
         }}}});
     gameEngine.registry.add_component(player, std::move(playerComponent));
 
-    networkingService.sendRequest(
+    room.sendRequest(
         *playersConnection[id].value(),
         GameStart,
         {});
@@ -166,7 +196,7 @@ core::ecs::Entity EntityFactory::createPlayer(
     const auto &worldTransformComponent = gameEngine.registry.get_component<core::ge::TransformComponent>(world);
     const auto &scroll = static_cast<uint32_t>(worldTransformComponent->position.x);
     {
-        networkingService.sendRequest(
+        room.sendRequest(
             *playersConnection[id].value(),
             MapScroll,
             {
@@ -191,7 +221,7 @@ core::ecs::Entity EntityFactory::createPlayer(
             }
         }
 
-        server.sendRequestToPlayers(PlayerMove, {
+        room.sendRequestToPlayers(PlayerMove, {
             id,
             static_cast<uint8_t>(x >> 24),
             static_cast<uint8_t>(x >> 16),
@@ -208,25 +238,30 @@ core::ecs::Entity EntityFactory::createPlayer(
     return player;
 }
 
-core::ecs::Entity EntityFactory::createEnemy(Server &server, const uint32_t x, uint8_t enemyType)
+// Snapshots carry 16-bit ids, the per-entity messages only a byte
+static uint16_t maxNetId(const Room &room)
 {
-    static uint8_t id = 0;
-    if (id >= 255)
+    return room.isSnapshotReplication() ? UINT16_MAX : UINT8_MAX;
+}
+
+core::ecs::Entity EntityFactory::createEnemy(Room &room, const uint32_t x, uint8_t enemyType)
+{
+    uint16_t &id = room.getNetIds().enemy;
+    if (id >= maxNetId(room))
         return core::ecs::Entity{};
 
-    auto &gameEngine = server.getGameEngine();
-    auto &networkingService = server.getNetworkingService();
-    const auto &config = server.getConfigManager();
-    const auto &playersConnection = server.getPlayersConnection();
+    auto &gameEngine = room.getGameEngine();
+    auto &networkingService = room.getNetworkingService();
+    const auto &config = room.getConfigManager();
+    const auto &playersConnection = room.getPlayersConnection();
 
     const auto currentId = id;
-    const std::function onCollision = [&, currentId](const core::ecs::Entity& entity, const core::ecs::Entity& otherEntity) {
+    const std::function onCollision = [&, currentId](const core::ecs::Entity& entity, const core::ecs::Entity&) {
         *gameEngine.out << "Enemy " << static_cast<int>(currentId) << " collided" << std::endl;
 
-        gameEngine.run_collision(ENEMY, otherEntity);
-
-        server.sendRequestToPlayers(EnemyDie, {currentId});
-        gameEngine.registry.kill_entity(entity);
+        if (!room.isSnapshotReplication())
+            room.sendRequestToPlayers(EnemyDie, {static_cast<uint8_t>(currentId)});
+        gameEngine.defer_kill(entity);
     };
 
     const core::ecs::Entity enemy = gameEngine.registry.spawn_entity();
@@ -249,26 +284,29 @@ core::ecs::Entity EntityFactory::createEnemy(Server &server, const uint32_t x, u
         {PLAYER_PROJECTILE, onCollision},
         {TILE, onCollision},
         {WORLD, onCollision}}});
-    gameEngine.registry.add_component(enemy, Enemy{id});
-
-    const std::vector payload = {
-        id,
-        enemyType,
-        static_cast<uint8_t>(position.x >> 24),
-        static_cast<uint8_t>(position.x >> 16),
-        static_cast<uint8_t>(position.x >> 8),
-        static_cast<uint8_t>(position.x),
-        static_cast<uint8_t>(position.y >> 24),
-        static_cast<uint8_t>(position.y >> 16),
-        static_cast<uint8_t>(position.y >> 8),
-        static_cast<uint8_t>(position.y)
-    };
-    for (auto &playerEntity : gameEngine.registry.get_entities<Player>()) {
-        const auto &playerComponent = gameEngine.registry.get_component<Player>(playerEntity);
-        networkingService.sendRequest(
-            *playersConnection[playerComponent->id].value(),
-            EnemySpawn,
-            payload);
+    gameEngine.registry.add_component(enemy, Enemy{id, enemyType});
+    gameEngine.registry.add_component(enemy, DeadReckoning{});
+
+    if (!room.isSnapshotReplication()) {
+        const std::vector payload = {
+            static_cast<uint8_t>(id),
+            enemyType,
+            static_cast<uint8_t>(position.x >> 24),
+            static_cast<uint8_t>(position.x >> 16),
+            static_cast<uint8_t>(position.x >> 8),
+            static_cast<uint8_t>(position.x),
+            static_cast<uint8_t>(position.y >> 24),
+            static_cast<uint8_t>(position.y >> 16),
+            static_cast<uint8_t>(position.y >> 8),
+            static_cast<uint8_t>(position.y)
+        };
+        for (auto &playerEntity : gameEngine.registry.get_entities<Player>()) {
+            const auto &playerComponent = gameEngine.registry.get_component<Player>(playerEntity);
+            room.sendRequest(
+                *playersConnection[playerComponent->id].value(),
+                EnemySpawn,
+                payload);
+        }
     }
 
     *gameEngine.out << "Enemy " << static_cast<int>(id++) << " created" << std::endl;
@@ -276,26 +314,26 @@ core::ecs::Entity EntityFactory::createEnemy(Server &server, const uint32_t x, u
 }
 
 core::ecs::Entity EntityFactory::createProjectile(
-    Server &server,
+    Room &room,
     const core::ecs::Entity &player)
 {
-    static uint8_t id = 0;
-    if (id >= 255) {
+    uint16_t &id = room.getNetIds().projectile;
+    if (id >= maxNetId(room)) {
         id = 0;
         return core::ecs::Entity{};
     }
 
-    auto &gameEngine = server.getGameEngine();
-    const auto &config = server.getConfigManager();
+    auto &gameEngine = room.getGameEngine();
+    const auto &config = room.getConfigManager();
 
-    const uint8_t currentId = id;
-    const auto onCollision = [&, currentId](const core::ecs::Entity& entity, const core::ecs::Entity& otherEntity) {
+    const uint16_t currentId = id;
+    const auto onCollision = [&, currentId](const core::ecs::Entity& entity, const core::ecs::Entity&) {
         *gameEngine.out << "Projectile " << static_cast<int>(currentId) << " died" << std::endl;
 
-        gameEngine.run_collision(PLAYER_PROJECTILE, otherEntity);
-        gameEngine.registry.kill_entity(entity);
+        gameEngine.defer_kill(entity);
 
-        server.sendRequestToPlayers(PlayerProjectileDestroy, {currentId});
+        if (!room.isSnapshotReplication())
+            room.sendRequestToPlayers(PlayerProjectileDestroy, {static_cast<uint8_t>(currentId)});
     };
 
     const core::ecs::Entity projectile = gameEngine.registry.spawn_entity();
@@ -313,19 +351,21 @@ core::ecs::Entity EntityFactory::createProjectile(
 
     gameEngine.registry.add_component(projectile, core::ge::VelocityComponent{config.getValue<float>("/player/weapons/0/speed/x", 500.0f), config.getValue<float>("/player/weapons/0/speed/y", 0.0f)});
     gameEngine.registry.add_component(projectile, core::ge::TransformComponent{pos, size, sf::Vector2f(1, 1), 0});
+    gameEngine.registry.add_component(projectile, core::ge::ContinuousCollisionComponent{pos, true});
     gameEngine.registry.add_component(projectile, core::ge::CollisionComponent{PLAYER_PROJECTILE, std::vector{sf::FloatRect(0, 0, size.x, size.y)},{
         {ENEMY, onCollision},
         {WORLD, onCollision},
         {TILE, onCollision}}});
     gameEngine.registry.add_component(projectile, Projectile{id});
+    gameEngine.registry.add_component(projectile, DeadReckoning{});
 
 
-    {
+    if (!room.isSnapshotReplication()) {
         const auto x = static_cast<uint32_t>(pos.x);
         const auto y = static_cast<uint32_t>(pos.y);
 
-        server.sendRequestToPlayers(PlayerProjectileCreate, {
-            id,
+        room.sendRequestToPlayers(PlayerProjectileCreate, {
+            static_cast<uint8_t>(id),
             static_cast<uint8_t>(x >> 24),
             static_cast<uint8_t>(x >> 16),
             static_cast<uint8_t>(x >> 8),
@@ -337,31 +377,31 @@ core::ecs::Entity EntityFactory::createProjectile(
         });
     }
 
-    *gameEngine.out << "Projectile " << static_cast<int>(id) << " created" << std::endl;
+    *gameEngine.out << "Projectile " << static_cast<int>(id++) << " created" << std::endl;
     return projectile;
 }
 
 core::ecs::Entity EntityFactory::createMissile(
-    Server &server,
+    Room &room,
     const core::ecs::Entity &player)
 {
-    static uint8_t id = 0;
-    if (id >= 255) {
+    uint16_t &id = room.getNetIds().missile;
+    if (id >= maxNetId(room)) {
         id = 0;
         return core::ecs::Entity{};
     }
 
-    auto &gameEngine = server.getGameEngine();
-    const auto &config = server.getConfigManager();
+    auto &gameEngine = room.getGameEngine();
+    const auto &config = room.getConfigManager();
 
-    const uint8_t currentId = id;
-    const auto onCollision = [&, currentId](const core::ecs::Entity& entity, const core::ecs::Entity& otherEntity) {
+    const uint16_t currentId = id;
+    const auto onCollision = [&, currentId](const core::ecs::Entity& entity, const core::ecs::Entity&) {
         *gameEngine.out << "Projectile " << static_cast<int>(currentId) << " died" << std::endl;
 
-        gameEngine.run_collision(PLAYER_PROJECTILE, otherEntity);
-        gameEngine.registry.kill_entity(entity);
+        gameEngine.defer_kill(entity);
 
-        server.sendRequestToPlayers(PlayerMissileDestroy, {currentId});
+        if (!room.isSnapshotReplication())
+            room.sendRequestToPlayers(PlayerMissileDestroy, {static_cast<uint8_t>(currentId)});
     };
 
     const core::ecs::Entity projectile = gameEngine.registry.spawn_entity();
@@ -379,18 +419,20 @@ core::ecs::Entity EntityFactory::createMissile(
     );
     gameEngine.registry.add_component(projectile, core::ge::VelocityComponent{config.getValue<float>("/player/weapons/1/speed/x", 500.0f), config.getValue<float>("/player/weapons/1/speed/y", 0.0f)});
     gameEngine.registry.add_component(projectile, core::ge::TransformComponent{pos, size, sf::Vector2f(1, 1), 0});
+    gameEngine.registry.add_component(projectile, core::ge::ContinuousCollisionComponent{pos, true});
     gameEngine.registry.add_component(projectile, core::ge::CollisionComponent{PLAYER_PROJECTILE, std::vector{sf::FloatRect(0, 0, size.x, size.y)},{
         {ENEMY, onCollision},
         {WORLD, onCollision},
         {TILE, onCollision}}});
-    gameEngine.registry.add_component(projectile, Projectile{id});
+    gameEngine.registry.add_component(projectile, Missile{id});
+    gameEngine.registry.add_component(projectile, DeadReckoning{});
 
-    {
+    if (!room.isSnapshotReplication()) {
         const auto x = static_cast<uint32_t>(pos.x);
         const auto y = static_cast<uint32_t>(pos.y);
 
-        server.sendRequestToPlayers(PlayerMissileCreate, {
-            id,
+        room.sendRequestToPlayers(PlayerMissileCreate, {
+            static_cast<uint8_t>(id),
             static_cast<uint8_t>(x >> 24),
             static_cast<uint8_t>(x >> 16),
             static_cast<uint8_t>(x >> 8),
@@ -402,24 +444,23 @@ core::ecs::Entity EntityFactory::createMissile(
         });
     }
 
-    *gameEngine.out << "Missile " << static_cast<int>(id) << " created" << std::endl;
+    *gameEngine.out << "Missile " << static_cast<int>(id++) << " created" << std::endl;
     return projectile;
 }
 
 
 core::ecs::Entity EntityFactory::createTile(
-    Server &server,
+    Room &room,
     const std::pair<uint32_t, uint32_t> &size,
     const uint32_t x,
     const uint32_t y)
 {
-    core::GameEngine &gameEngine = server.getGameEngine();
+    core::GameEngine &gameEngine = room.getGameEngine();
 
-    const auto onCollision = [&](const core::ecs::Entity& entity, const core::ecs::Entity& otherEntity) {
+    const auto onCollision = [&, x = x * size.first, y = y * size.second](const core::ecs::Entity& entity, const core::ecs::Entity&) {
         *gameEngine.out << "Tile collided" << std::endl;
 
-        gameEngine.run_collision(TILE, otherEntity);
-        server.sendRequestToPlayers(TileDestroy, {
+        room.sendRequestToPlayers(TileDestroy, {
             static_cast<uint8_t>(x >> 24),
             static_cast<uint8_t>(x >> 16),
             static_cast<uint8_t>(x >> 8),
@@ -429,7 +470,7 @@ core::ecs::Entity EntityFactory::createTile(
             static_cast<uint8_t>(y >> 8),
             static_cast<uint8_t>(y)
         });
-        gameEngine.registry.kill_entity(entity);
+        gameEngine.defer_kill(entity);
     };
 
     const core::ecs::Entity tile = gameEngine.registry.spawn_entity();
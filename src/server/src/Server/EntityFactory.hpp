@@ -1,15 +1,16 @@
 #ifndef ENTITYFACTORY_HPP
 #define ENTITYFACTORY_HPP
 
-#include "Server.hpp"
+#include "Room.hpp"
 
 namespace EntityFactory {
-    core::ecs::Entity createWorld(Server &server, const std::string& filePath);
-    core::ecs::Entity createPlayer(Server &server, uint8_t id);
-    core::ecs::Entity createEnemy(Server &server,  uint32_t x, uint8_t enemyType = 0);
-    core::ecs::Entity createProjectile(Server &server, const core::ecs::Entity &player);
-    core::ecs::Entity createMissile(Server &server, const core::ecs::Entity &player);
-    core::ecs::Entity createTile(Server &server, const std::pair<uint32_t, uint32_t> &size, uint32_t x, uint32_t y);
+    core::ecs::Entity createWorld(Room &room, const std::string& filePath);
+    core::ecs::Entity createPlayer(Room &room, uint8_t id);
+    core::ecs::Entity createEnemy(Room &room,  uint32_t x, uint8_t enemyType = 0);
+    core::ecs::Entity createProjectile(Room &room, const core::ecs::Entity &player);
+    core::ecs::Entity createMissile(Room &room, const core::ecs::Entity &player);
+    core::ecs::Entity createTile(Room &room, const std::pair<uint32_t, uint32_t> &size, uint32_t x, uint32_t y);
+    core::ecs::Entity createStaticTiles(Room &room, const std::vector<std::vector<bool>> &solidTiles, uint32_t tileSize);
 };
 
 #endif //ENTITYFACTORY_HPP
@@ -2,109 +2,174 @@
 
 #include "Components.hpp"
 #include "EntityFactory.hpp"
+#include "../../../game/Movement.hpp"
 #include "../../../game/RequestType.hpp"
 
-void EventFactory::gameStarted(Server &server)
+// The network thread only decodes messages into commands for the sender's room,
+// the room's worker applies them at the start of its next tick.
+
+static void post(Server &server, const asio::ip::udp::endpoint &endpoint, const Command &command)
 {
-    const NetworkingService &networkingService = server.getNetworkingService();
+    const auto room = server.findRoom(endpoint);
+    if (!room)
+        return;
+    if (!room->post(command))
+        server.log() << "Room " << room->getId() << ": command queue full, dropping a message from " << endpoint << std::endl;
+}
 
-    networkingService.addEvent(GameStart, [&](const GDTPHeader &, const std::vector<uint8_t> &payload, const asio::ip::udp::endpoint &) {
-        if (!payload.empty())
-            return;
+namespace {
+    using Endpoint = asio::ip::udp::endpoint;
+    template <uint8_t Type>
+    using Message = NetworkingService::Message<Type>;
 
-        std::lock_guard lock(server.getRegistryMutex());
+    // Handlers of the messages clients send, dispatched at compile time on their type
+    struct ClientMessages {
+        Server &server;
 
-        server.start();
-    });
-}
+        void operator()(Message<GameStart>, const GDTPHeader &, const std::span<const uint8_t> payload, const Endpoint &endpoint) const
+        {
+            if (!payload.empty())
+                return;
 
-void EventFactory::playerConnected(Server &server)
-{
-    auto &gameEngine = server.getGameEngine();
-    auto &networkingService = server.getNetworkingService();
-    auto &playersConnection = server.getPlayersConnection();
-    auto &players = server.getPlayers();
+            post(server, endpoint, {.type = CommandType::Start});
+        }
 
-    networkingService.addEvent(PlayerConnect, [&](const GDTPHeader &header, const std::vector<uint8_t> &payload, const asio::ip::udp::endpoint &endpoint) {
-        if (!payload.empty())
-            return;
+        void operator()(Message<PlayerConnect>, const GDTPHeader &header, const std::span<const uint8_t> payload, const Endpoint &endpoint) const
+        {
+            if (!payload.empty())
+                return;
 
-        std::lock_guard lock(server.getRegistryMutex());
+            const auto room = server.joinRoom(endpoint);
+            if (!room)
+                return;
 
-        uint8_t id = 0;
-        for (; id < 4; id++) {
-            if (playersConnection[id].has_value())
-                continue;
-            *gameEngine.out << "New connection from " << endpoint << std::endl;
-            playersConnection[id] = std::make_shared<asio::ip::udp::endpoint>(endpoint);
-            break;
+            if (!room->post({.type = CommandType::Connect, .endpoint = endpoint, .header = header})) {
+                server.log() << "Room " << room->getId() << ": command queue full, refusing " << endpoint << std::endl;
+                room->releaseSeat();
+                server.leaveRoom(endpoint);
+            }
         }
-        if (id == 4)
-            return;
 
-        // send the new player to himself
-        networkingService.sendRequestResponse(endpoint, header, {id});
+        void operator()(Message<PlayerDisconnect>, const GDTPHeader &, const std::span<const uint8_t> payload, const Endpoint &endpoint) const
+        {
+            if (payload.size() != 1)
+                return;
 
-        for (uint8_t i = 0; i < 4; i++) {
-            if (!playersConnection[i].has_value() || i == id)
-                continue;
-            // send all players to the new player
-            networkingService.sendRequest(
-                endpoint,
-                PlayerConnect,
-                {i});
-            // send the new player to all players
-            networkingService.sendRequest(
-                *playersConnection[i].value(),
-                PlayerConnect,
-                {i});
+            post(server, endpoint, {.type = CommandType::Disconnect, .player = payload[0], .endpoint = endpoint});
         }
 
-        if (server.getGameState() != GAME)
-            return;
+        void operator()(Message<PlayerInput>, const GDTPHeader &, const std::span<const uint8_t> payload, const Endpoint &endpoint) const
+        {
+            if (payload.size() != movement::INPUT_PAYLOAD_SIZE)
+                return;
+
+            post(server, endpoint, {
+                .type = CommandType::Input,
+                .player = payload[0],
+                .input = payload[5],
+                .sequence = static_cast<uint32_t>((payload[1] << 24) | (payload[2] << 16) | (payload[3] << 8) | payload[4]),
+                .endpoint = endpoint
+            });
+        }
 
-        players[id] = EntityFactory::createPlayer(server, id);
+        void operator()(Message<PlayerProjectileShoot>, const GDTPHeader &, const std::span<const uint8_t> payload, const Endpoint &endpoint) const
+        {
+            if (payload.size() != 1)
+                return;
 
-        // Send all player positions to the new player
-        for (uint8_t i = 0; i < 4; i++) {
-            if (!players[i].has_value() || i == id)
-                continue;
-            const auto &transformComponent = server.getGameEngine().registry.get_component<core::ge::TransformComponent>(players[i].value());
-            const auto x = static_cast<uint32_t>(transformComponent->position.x);
-            const auto y = static_cast<uint32_t>(transformComponent->position.y);
-
-            for (uint8_t j = 0; j < 4; j++) {
-                if (!playersConnection[j].has_value() || j == id)
-                    continue;
-                networkingService.sendRequest(
-                    endpoint,
-                    PlayerMove,
-                    {
-                        i,
-                        static_cast<uint8_t>(x >> 24),
-                        static_cast<uint8_t>(x >> 16),
-                        static_cast<uint8_t>(x >> 8),
-                        static_cast<uint8_t>(x),
-                        static_cast<uint8_t>(y >> 24),
-                        static_cast<uint8_t>(y >> 16),
-                        static_cast<uint8_t>(y >> 8),
-                        static_cast<uint8_t>(y)
-                    });
-            }
+            post(server, endpoint, {.type = CommandType::ShootProjectile, .player = payload[0], .endpoint = endpoint});
+        }
+
+        void operator()(Message<PlayerMissileShoot>, const GDTPHeader &, const std::span<const uint8_t> payload, const Endpoint &endpoint) const
+        {
+            if (payload.size() != 1)
+                return;
+
+            post(server, endpoint, {.type = CommandType::ShootMissile, .player = payload[0], .endpoint = endpoint});
         }
 
-        // Send all enemies to the new player
-        for (const auto &enemy : server.getGameEngine().registry.get_entities<Enemy>()) {
-            const auto enemyComponent = server.getGameEngine().registry.get_component<Enemy>(enemy);
-            const auto &transformComponent = server.getGameEngine().registry.get_component<core::ge::TransformComponent>(enemy);
-            const auto x = static_cast<uint32_t>(transformComponent->position.x);
-            const auto y = static_cast<uint32_t>(transformComponent->position.y);
+        void operator()(Message<SnapshotAck>, const GDTPHeader &, const std::span<const uint8_t> payload, const Endpoint &endpoint) const
+        {
+            if (payload.size() != 5)
+                return;
+
+            post(server, endpoint, {
+                .type = CommandType::AckSnapshot,
+                .player = payload[0],
+                .tick = static_cast<uint32_t>((payload[1] << 24) | (payload[2] << 16) | (payload[3] << 8) | payload[4]),
+                .endpoint = endpoint
+            });
+        }
+    };
+}
 
-            networkingService.sendRequest(
+void EventFactory::clientMessages(Server &server)
+{
+    server.getNetworkingService().setStaticHandlers<
+        GameStart,
+        PlayerConnect,
+        PlayerDisconnect,
+        PlayerInput,
+        PlayerProjectileShoot,
+        PlayerMissileShoot,
+        SnapshotAck
+    >(ClientMessages{server});
+}
+
+static void connect(Room &room, const Command &command)
+{
+    auto &playersConnection = room.getPlayersConnection();
+    auto &players = room.getPlayers();
+
+    const auto connected = room.connect(command.endpoint);
+    if (!connected)
+        return;
+    const uint8_t id = *connected;
+    const auto &endpoint = command.endpoint;
+
+    // send the new player to himself
+    room.sendRequestResponse(endpoint, command.header, {id});
+
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!playersConnection[i].has_value() || i == id)
+            continue;
+        // send all players to the new player
+        room.sendRequest(
+            endpoint,
+            PlayerConnect,
+            {i});
+        // send the new player to all players
+        room.sendRequest(
+            *playersConnection[i].value(),
+            PlayerConnect,
+            {i});
+    }
+
+    if (room.getGameState() != GAME)
+        return;
+
+    players[id] = EntityFactory::createPlayer(room, id);
+
+    // The first world snapshot carries the whole world to the new player
+    if (room.isSnapshotReplication())
+        return;
+
+    // Send all player positions to the new player
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!players[i].has_value() || i == id)
+            continue;
+        const auto &transformComponent = room.getGameEngine().registry.get_component<core::ge::TransformComponent>(players[i].value());
+        const auto x = static_cast<uint32_t>(transformComponent->position.x);
+        const auto y = static_cast<uint32_t>(transformComponent->position.y);
+
+        for (uint8_t j = 0; j < 4; j++) {
+            if (!playersConnection[j].has_value() || j == id)
+                continue;
+            room.sendRequest(
                 endpoint,
-                EnemySpawn,
+                PlayerMove,
                 {
-                    enemyComponent->id,
+                    i,
                     static_cast<uint8_t>(x >> 24),
                     static_cast<uint8_t>(x >> 16),
                     static_cast<uint8_t>(x >> 8),
@@ -115,115 +180,155 @@ void EventFactory::playerConnected(Server &server)
                     static_cast<uint8_t>(y)
                 });
         }
-    });
+    }
+
+    // Send all enemies to the new player
+    for (const auto &enemy : room.getGameEngine().registry.get_entities<Enemy>()) {
+        const auto enemyComponent = room.getGameEngine().registry.get_component<Enemy>(enemy);
+        const auto &transformComponent = room.getGameEngine().registry.get_component<core::ge::TransformComponent>(enemy);
+        const auto x = static_cast<uint32_t>(transformComponent->position.x);
+        const auto y = static_cast<uint32_t>(transformComponent->position.y);
+
+        room.sendRequest(
+            endpoint,
+            EnemySpawn,
+            {
+                static_cast<uint8_t>(enemyComponent->id),
+                static_cast<uint8_t>(x >> 24),
+                static_cast<uint8_t>(x >> 16),
+                static_cast<uint8_t>(x >> 8),
+                static_cast<uint8_t>(x),
+                static_cast<uint8_t>(y >> 24),
+                static_cast<uint8_t>(y >> 16),
+                static_cast<uint8_t>(y >> 8),
+                static_cast<uint8_t>(y)
+            });
+    }
 }
 
-void EventFactory::playerDisconnected(Server &server)
+static void disconnect(Server &server, Room &room, const Command &command)
 {
-    const NetworkingService &networkingService = server.getNetworkingService();
-    core::GameEngine &gameEngine = server.getGameEngine();
-    auto &playersConnection = server.getPlayersConnection();
-    auto &players = server.getPlayers();
-
-    networkingService.addEvent(PlayerDisconnect, [&](const GDTPHeader &, const std::vector<uint8_t> &payload, const asio::ip::udp::endpoint &) {
-        if (payload.size() != 1)
-            return;
+    core::GameEngine &gameEngine = room.getGameEngine();
+    auto &playersConnection = room.getPlayersConnection();
+    auto &players = room.getPlayers();
 
-        std::lock_guard lock(server.getRegistryMutex());
+    const uint8_t id = command.player;
+    if (id >= 4 || !playersConnection[id].has_value())
+        return;
 
-        const uint8_t id = payload[0];
-        if (id >= 4 || !playersConnection[id].has_value())
-            return;
+    *gameEngine.out << "Room " << room.getId() << ": player " << static_cast<int>(id)
+        << (command.type == CommandType::Kick ? " kicked" : " disconnected") << std::endl;
+    server.leaveRoom(*playersConnection[id].value());
+    playersConnection[id].reset();
 
-        *gameEngine.out << "Player " << static_cast<int>(id) << " disconnected" << std::endl;
-        playersConnection[id].reset();
-
-        if (!players[id].has_value())
-            return;
+    if (players[id].has_value()) {
         gameEngine.registry.kill_entity(players[id].value());
         players[id].reset();
+    }
 
-        if (server.asPlayerConnected())
-            return;
-        server.setGameState(STOPPING);
-    });
+    // The last player leaving closes the room, which the server reaps
+    room.releaseSeat();
 }
 
-void EventFactory::playerMove(Server &server)
+static void input(Room &room, const Command &command)
 {
-    const NetworkingService &networkingService = server.getNetworkingService();
-    core::GameEngine &gameEngine = server.getGameEngine();
-    const auto &players = server.getPlayers();
-
-    networkingService.addEvent(PlayerMove, [&](const GDTPHeader &, const std::vector<uint8_t> &payload, const asio::ip::udp::endpoint &) {
-        if (payload.size() != 9)
-            return;
-
-        std::lock_guard lock(server.getRegistryMutex());
-
-        const uint8_t id = payload[0];
-        if (id >= 4 || !players[id].has_value())
-            return;
-
-        {
-            const auto &transformComponent = gameEngine.registry.get_component<core::ge::TransformComponent>(players[id].value());
-            transformComponent->position = {
-                static_cast<float>((payload[1] << 24) | (payload[2] << 16) | (payload[3] << 8) | payload[4]),
-                static_cast<float>((payload[5] << 24) | (payload[6] << 16) | (payload[7] << 8) | payload[8])
-            };
-        }
-
-        {
-            const auto &playerComponent = gameEngine.registry.get_component<Player>(players[id].value());
-            playerComponent->lastTimePacketReceived = std::time(nullptr);
-        }
-
-        server.sendRequestToPlayers(PlayerMove, payload, id);
-    });
+    core::GameEngine &gameEngine = room.getGameEngine();
+    const auto &players = room.getPlayers();
+
+    const uint8_t id = command.player;
+    if (id >= 4 || !players[id].has_value())
+        return;
+
+    const auto &playerComponent = gameEngine.registry.get_component<Player>(players[id].value());
+    playerComponent->lastTimePacketReceived = std::time(nullptr);
+    if (!movement::isNewer(command.sequence, playerComponent->inputSequence))
+        return;
+
+    // Acknowledged even when dropped, the client replays its inputs from the position it really has
+    playerComponent->inputSequence = command.sequence;
+    const float interval = room.getInputInterval();
+    if (playerComponent->inputBudget <= -interval)
+        return;
+    playerComponent->inputBudget -= interval;
+
+    const sf::Vector2f step = movement::velocity(command.input, room.getPlayerSpeed()) * interval;
+    const bool moving = step.x != 0 || step.y != 0;
+    const auto &transformComponent = gameEngine.registry.get_component<core::ge::TransformComponent>(players[id].value());
+    transformComponent->position += step;
+
+    // Snapshots carry the positions, otherwise the other players are told, once more when the player stops
+    const bool wasMoving = playerComponent->moving;
+    playerComponent->moving = moving;
+    if (room.isSnapshotReplication() || (!moving && !wasMoving))
+        return;
+    const auto x = static_cast<uint32_t>(transformComponent->position.x);
+    const auto y = static_cast<uint32_t>(transformComponent->position.y);
+    room.sendRequestToPlayers(PlayerMove, {
+        id,
+        static_cast<uint8_t>(x >> 24),
+        static_cast<uint8_t>(x >> 16),
+        static_cast<uint8_t>(x >> 8),
+        static_cast<uint8_t>(x),
+        static_cast<uint8_t>(y >> 24),
+        static_cast<uint8_t>(y >> 16),
+        static_cast<uint8_t>(y >> 8),
+        static_cast<uint8_t>(y)
+    }, id);
 }
 
-void EventFactory::playerProjectileShoot(Server &server)
+static void shoot(Room &room, const Command &command)
 {
-    const NetworkingService &networkingService = server.getNetworkingService();
-    core::GameEngine &gameEngine = server.getGameEngine();
-    const std::array<std::optional<core::ecs::Entity>, 4> &players = server.getPlayers();
-
-    networkingService.addEvent(PlayerProjectileShoot, [&](const GDTPHeader &, const std::vector<uint8_t> &payload, const asio::ip::udp::endpoint &) {
-        if (payload.size() != 1)
-            return;
+    core::GameEngine &gameEngine = room.getGameEngine();
+    const std::array<std::optional<core::ecs::Entity>, 4> &players = room.getPlayers();
 
-        std::lock_guard lock(server.getRegistryMutex());
+    const uint8_t id = command.player;
+    if (id >= 4 || !players[id].has_value())
+        return;
 
-        const uint8_t id = payload[0];
-        if (id >= 4 || !players[id].has_value())
-            return;
+    if (command.type == CommandType::ShootMissile)
+        EntityFactory::createMissile(room, players[id].value());
+    else
+        EntityFactory::createProjectile(room, players[id].value());
 
-        EntityFactory::createProjectile(server, players[id].value());
-
-        const auto &playerComponent = gameEngine.registry.get_component<Player>(players[id].value());
-        playerComponent->lastTimePacketReceived = std::time(nullptr);
-    });
+    const auto &playerComponent = gameEngine.registry.get_component<Player>(players[id].value());
+    playerComponent->lastTimePacketReceived = std::time(nullptr);
 }
 
-void EventFactory::playerMissileShoot(Server &server)
+// A client only speaks for the player of its endpoint: a command naming another player is ignored
+static bool fromPlayer(const Room &room, const Command &command)
 {
-    const NetworkingService &networkingService = server.getNetworkingService();
-    core::GameEngine &gameEngine = server.getGameEngine();
-    const std::array<std::optional<core::ecs::Entity>, 4> &players = server.getPlayers();
-
-    networkingService.addEvent(PlayerMissileShoot, [&](const GDTPHeader &, const std::vector<uint8_t> &payload, const asio::ip::udp::endpoint &) {
-        if (payload.size() != 1)
-            return;
-
-        std::lock_guard lock(server.getRegistryMutex());
-
-        const uint8_t id = payload[0];
-        if (id >= 4 || !players[id].has_value())
-            return;
-
-        EntityFactory::createMissile(server, players[id].value());
+    const auto id = room.findPlayer(command.endpoint);
+    return id && *id == command.player;
+}
 
-        const auto &playerComponent = gameEngine.registry.get_component<Player>(players[id].value());
-        playerComponent->lastTimePacketReceived = std::time(nullptr);
-    });
+void EventFactory::execute(Server &server, Room &room, const Command &command)
+{
+    switch (command.type) {
+        case CommandType::Connect:
+            connect(room, command);
+            break;
+        case CommandType::Disconnect:
+            if (fromPlayer(room, command))
+                disconnect(server, room, command);
+            break;
+        case CommandType::Kick:
+            disconnect(server, room, command);
+            break;
+        case CommandType::Start:
+            room.start();
+            break;
+        case CommandType::Input:
+            if (fromPlayer(room, command))
+                input(room, command);
+            break;
+        case CommandType::ShootProjectile:
+        case CommandType::ShootMissile:
+            if (fromPlayer(room, command))
+                shoot(room, command);
+            break;
+        case CommandType::AckSnapshot:
+            if (fromPlayer(room, command))
+                room.getReplication().acknowledge(command.player, command.tick);
+            break;
+    }
 }
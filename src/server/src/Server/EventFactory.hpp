@@ -4,12 +4,11 @@
 #include "Server.hpp"
 
 namespace EventFactory {
-    void gameStarted(Server &server);
-    void playerConnected(Server &server);
-    void playerDisconnected(Server &server);
-    void playerMove(Server &server);
-    void playerProjectileShoot(Server &server);
-    void playerMissileShoot(Server &server);
+    // Sets the handlers of every message clients send
+    void clientMessages(Server &server);
+
+    // Applies a queued command to the room, on the room's worker
+    void execute(Server &server, Room &room, const Command &command);
 };
 
 #endif //EVENTFACTORY_HPP
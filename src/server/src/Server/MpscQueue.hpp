@@ -0,0 +1,75 @@
+#ifndef MPSCQUEUE_HPP
+#define MPSCQUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+// Bounded lock-free queue for many producer threads and a single consumer thread.
+// Each cell carries a sequence number telling whether it is free for the producer of a given position
+// or filled for the consumer, so producers only contend on one atomic increment.
+template <typename T, size_t Capacity>
+class MpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MpscQueue capacity must be a power of two");
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    static constexpr size_t MASK = Capacity - 1;
+
+    std::array<Cell, Capacity> _cells;
+    alignas(64) std::atomic<size_t> _tail = 0;
+    alignas(64) size_t _head = 0;
+
+public:
+    MpscQueue()
+    {
+        for (size_t i = 0; i < Capacity; i++)
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    // Any thread; fails without blocking when the queue is full
+    bool push(T value)
+    {
+        size_t position = _tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = _cells[position & MASK];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0) {
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0)
+                return false;
+            else
+                position = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer thread only
+    std::optional<T> pop()
+    {
+        Cell &cell = _cells[_head & MASK];
+        if (cell.sequence.load(std::memory_order_acquire) != _head + 1)
+            return std::nullopt;
+
+        std::optional<T> value = std::move(cell.value);
+        cell.sequence.store(_head + Capacity, std::memory_order_release);
+        ++_head;
+        return value;
+    }
+};
+
+#endif //MPSCQUEUE_HPP
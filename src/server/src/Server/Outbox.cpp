@@ -0,0 +1,46 @@
+#include "Outbox.hpp"
+
+#include <algorithm>
+
+#include "../../../game/Batch.hpp"
+#include "../../../game/RequestType.hpp"
+
+void Outbox::add(const asio::ip::udp::endpoint &endpoint, const uint8_t messageType, std::vector<uint8_t> payload)
+{
+    auto destination = std::ranges::find(_destinations, endpoint, &std::pair<asio::ip::udp::endpoint, std::vector<Message>>::first);
+    if (destination == _destinations.end())
+        destination = _destinations.insert(destination, {endpoint, {}});
+    destination->second.push_back({messageType, std::move(payload)});
+}
+
+void Outbox::flush(SendQueue &sendQueue)
+{
+    for (auto &[endpoint, messages] : _destinations) {
+        // Messages waiting for the current datagram, sent bare when alone
+        size_t first = 0;
+        size_t size = 0;
+
+        const auto send = [&](const size_t last) {
+            if (last - first == 1)
+                sendQueue.push({endpoint, std::nullopt, messages[first].messageType, std::move(messages[first].payload)});
+            else if (last > first) {
+                std::vector<uint8_t> payload;
+                payload.reserve(size);
+                for (size_t i = first; i < last; i++)
+                    batch::append(payload, messages[i].messageType, messages[i].payload);
+                sendQueue.push({endpoint, std::nullopt, Batch, std::move(payload)});
+            }
+            first = last;
+            size = 0;
+        };
+
+        for (size_t i = 0; i < messages.size(); i++) {
+            const size_t framed = batch::framedSize(messages[i].payload.size());
+            if (size + framed > batch::MAX_PAYLOAD)
+                send(i);
+            size += framed;
+        }
+        send(messages.size());
+    }
+    _destinations.clear();
+}
@@ -0,0 +1,25 @@
+#ifndef OUTBOX_HPP
+#define OUTBOX_HPP
+
+#include <utility>
+#include <vector>
+
+#include "SendQueue.hpp"
+
+// Messages a room sends during a tick, coalesced per destination into as few datagrams as possible when flushed
+class Outbox {
+private:
+    struct Message {
+        uint8_t messageType;
+        std::vector<uint8_t> payload;
+    };
+
+    // A room has at most four destinations: a linear lookup beats a map
+    std::vector<std::pair<asio::ip::udp::endpoint, std::vector<Message>>> _destinations;
+
+public:
+    void add(const asio::ip::udp::endpoint &endpoint, uint8_t messageType, std::vector<uint8_t> payload);
+    void flush(SendQueue &sendQueue);
+};
+
+#endif //OUTBOX_HPP
@@ -0,0 +1,127 @@
+#include "Replication.hpp"
+
+#include "Components.hpp"
+#include "../../../core/ecs/GameEngine/GameEngineComponents.hpp"
+
+#include <cmath>
+
+// Keeps the replicated motion of a moving entity while the entity follows it
+static const ReplicatedEntity &deadReckon(
+    DeadReckoning &deadReckoning, const ReplicatedEntity &current, const core::ge::VelocityComponent &velocity,
+    const float tickDuration, const float correctionThreshold)
+{
+    ReplicatedEntity &motion = deadReckoning.motion;
+    const auto vx = static_cast<int16_t>(std::lround(velocity.dx));
+    const auto vy = static_cast<int16_t>(std::lround(velocity.dy));
+    const auto [x, y] = motion.positionAt(current.tick, tickDuration);
+    if (motion.tick == 0 || motion.netId != current.netId || motion.type != current.type || motion.vx != vx || motion.vy != vy
+        || std::hypot(x - static_cast<float>(current.x), y - static_cast<float>(current.y)) > correctionThreshold) {
+        motion = current;
+        motion.vx = vx;
+        motion.vy = vy;
+    }
+    return motion;
+}
+
+template<typename Tag>
+static void captureKind(
+    core::ecs::Registry &registry, const ReplicatedKind kind, WorldSnapshot &snapshot, const float tickDuration,
+    const float correctionThreshold, const std::optional<sf::FloatRect> &interest)
+{
+    for (const auto &entity : registry.get_entities<Tag, core::ge::TransformComponent>()) {
+        const auto &tag = registry.get_component<Tag>(entity);
+        const auto &transform = registry.get_component<core::ge::TransformComponent>(entity);
+        if (interest.has_value() && !interest->intersects({transform->position, transform->size}))
+            continue;
+        uint8_t type = 0;
+        if constexpr (std::is_same_v<Tag, Enemy>)
+            type = tag->type;
+
+        const ReplicatedEntity current{
+            ReplicatedEntity::makeId(kind, tag->id),
+            type,
+            static_cast<int32_t>(transform->position.x),
+            static_cast<int32_t>(transform->position.y),
+            0,
+            0,
+            snapshot.tick};
+        // Players move on input and are sent as they are, the entity factory gives the others their dead reckoning
+        if constexpr (!std::is_same_v<Tag, Player>) {
+            if (registry.has_component<core::ge::VelocityComponent>(entity) && registry.has_component<DeadReckoning>(entity)) {
+                const auto &velocity = registry.get_component<core::ge::VelocityComponent>(entity);
+                const auto &deadReckoning = registry.get_component<DeadReckoning>(entity);
+                snapshot.entities.push_back(deadReckon(*deadReckoning, current, *velocity, tickDuration, correctionThreshold));
+                continue;
+            }
+        }
+        snapshot.entities.push_back({current.netId, current.type, current.x, current.y});
+    }
+}
+
+std::optional<sf::FloatRect> Replication::interestArea(core::ecs::Registry &registry, const float margin)
+{
+    const auto worlds = registry.get_entities<World, core::ge::TransformComponent>();
+    if (worlds.empty())
+        return std::nullopt;
+
+    const auto &transform = registry.get_component<core::ge::TransformComponent>(worlds.front());
+    return sf::FloatRect(
+        transform->position.x - margin,
+        transform->position.y - margin,
+        transform->size.x + 2 * margin,
+        transform->size.y + 2 * margin);
+}
+
+WorldSnapshot Replication::capture(
+    core::ecs::Registry &registry, const uint32_t tick, const float tickDuration, const float correctionThreshold,
+    const std::optional<sf::FloatRect> &interest)
+{
+    // Clients extrapolate with the server's tick duration, whatever rate it runs at
+    WorldSnapshot snapshot{tick, {}, 0, static_cast<uint32_t>(std::lround(tickDuration * 1e6f))};
+    captureKind<Player>(registry, ReplicatedKind::Player, snapshot, tickDuration, correctionThreshold, std::nullopt);
+    captureKind<Enemy>(registry, ReplicatedKind::Enemy, snapshot, tickDuration, correctionThreshold, interest);
+    captureKind<Projectile>(registry, ReplicatedKind::Projectile, snapshot, tickDuration, correctionThreshold, interest);
+    captureKind<Missile>(registry, ReplicatedKind::Missile, snapshot, tickDuration, correctionThreshold, interest);
+    snapshot.sort();
+    return snapshot;
+}
+
+void Replication::reset(const uint8_t client)
+{
+    _clients[client] = {};
+}
+
+void Replication::acknowledge(const uint8_t client, const uint32_t tick)
+{
+    auto &state = _clients[client];
+    if (tick <= state.ackedTick)
+        return;
+    // Only acknowledge snapshots that were actually sent and are still in the history.
+    if (std::ranges::none_of(state.history, [tick](const auto &snapshot) { return snapshot.tick == tick; }))
+        return;
+
+    state.ackedTick = tick;
+    while (!state.history.empty() && state.history.front().tick < tick)
+        state.history.pop_front();
+}
+
+std::vector<uint8_t> Replication::encode(const uint8_t client, const WorldSnapshot &snapshot, const uint32_t inputSequence)
+{
+    static const WorldSnapshot empty{};
+    auto &state = _clients[client];
+
+    const WorldSnapshot *base = &empty;
+    if (!state.history.empty() && state.history.front().tick == state.ackedTick)
+        base = &state.history.front();
+
+    std::vector<uint8_t> payload = snapshot::encode(*base, snapshot, inputSequence);
+
+    // Without acknowledgements the history is capped: the client then falls back to full snapshots.
+    if (state.history.size() >= HISTORY_SIZE) {
+        state.history.pop_front();
+        if (base != &empty)
+            state.ackedTick = 0;
+    }
+    state.history.push_back(snapshot);
+    return payload;
+}
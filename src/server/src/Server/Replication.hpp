@@ -0,0 +1,37 @@
+#ifndef REPLICATION_HPP
+#define REPLICATION_HPP
+
+#include <array>
+#include <deque>
+#include <optional>
+#include <SFML/Graphics/Rect.hpp>
+
+#include "../../../core/ecs/Registry/Registry.hpp"
+#include "../../../game/Snapshot.hpp"
+
+class Replication {
+public:
+    static constexpr size_t HISTORY_SIZE = 64;
+
+    // Area the clients need entities from: the scrolled view of the world, grown by a margin on every side
+    static std::optional<sf::FloatRect> interestArea(core::ecs::Registry &registry, float margin);
+    // Players are always captured; other entities only when they overlap the interest area, if any.
+    // Moving entities are dead reckoned: their motion is only updated once they stray from it by the threshold.
+    static WorldSnapshot capture(
+        core::ecs::Registry &registry, uint32_t tick, float tickDuration, float correctionThreshold,
+        const std::optional<sf::FloatRect> &interest = std::nullopt);
+
+    void reset(uint8_t client);
+    void acknowledge(uint8_t client, uint32_t tick);
+    std::vector<uint8_t> encode(uint8_t client, const WorldSnapshot &snapshot, uint32_t inputSequence);
+
+private:
+    struct ClientState {
+        std::deque<WorldSnapshot> history; // Snapshots sent to the client, oldest first
+        uint32_t ackedTick = 0;            // Most recent snapshot the client acknowledged, 0 if none
+    };
+
+    std::array<ClientState, 4> _clients;
+};
+
+#endif //REPLICATION_HPP
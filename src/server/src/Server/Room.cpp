@@ -0,0 +1,201 @@
+#include "Room.hpp"
+#include "Components.hpp"
+#include "EntityFactory.hpp"
+#include "EventFactory.hpp"
+#include "Systems.hpp"
+#include "../../../game/RequestType.hpp"
+
+#include <cmath>
+
+Room::Room(
+    const uint32_t id,
+    NetworkingService &networkingService,
+    SendQueue &sendQueue,
+    const ConfigManager &configManager,
+    std::ostream &log,
+    const float deltaTime)
+    : _id(id),
+      _networkingService(networkingService),
+      _sendQueue(sendQueue),
+      _configManager(configManager),
+      _log(log),
+      _gameEngine(false, &_log)
+{
+    // Every line is written to the shared log at once, whichever thread runs the room
+    _log.rdbuf()->set_emit_on_sync(true);
+
+    _gameEngine.registry.register_component<Network>();
+    _gameEngine.registry.register_component<World>();
+    _gameEngine.registry.register_component<Player>();
+    _gameEngine.registry.register_component<Enemy>();
+    _gameEngine.registry.register_component<Projectile>();
+    _gameEngine.registry.register_component<Missile>();
+    _gameEngine.registry.register_component<DeadReckoning>();
+
+    _gameEngine.collisionDetector.setThreads(_configManager.getValue<size_t>("/server/collisionThreads", 1));
+    _gameEngine.delta_t = deltaTime;
+    _snapshotReplication = _configManager.getValue<std::string>("/server/replication", "events") == "snapshot";
+    _interestMargin = _configManager.getValue<float>("/server/interestMargin", 256.0f);
+    _correctionThreshold = _configManager.getValue<float>("/server/correctionThreshold", 4.0f);
+    const float snapshotRate = std::max(_configManager.getValue<float>("/server/snapshotRate", 20.0f), 1.0f);
+    _snapshotInterval = std::max(static_cast<size_t>(std::lround(1.0f / (deltaTime * snapshotRate))), static_cast<size_t>(1));
+    _inputInterval = 1.0f / std::max(_configManager.getValue<float>("/network/inputRate", movement::DEFAULT_INPUT_RATE), 1.0f);
+    _playerSpeed = {_configManager.getValue<float>("/player/speed/x", 350.0f), _configManager.getValue<float>("/player/speed/y", 350.0f)};
+
+    Systems::worldSystem(*this);
+    Systems::playerMovement(*this);
+}
+
+bool Room::reserveSeat()
+{
+    uint8_t seats = _seats;
+    do {
+        if (seats >= 4)
+            return false;
+    } while (!_seats.compare_exchange_weak(seats, seats + 1));
+    return true;
+}
+
+void Room::releaseSeat()
+{
+    uint8_t seats = _seats;
+    do {
+        if (seats == 0 || seats == CLOSED)
+            return;
+    } while (!_seats.compare_exchange_weak(seats, seats == 1 ? CLOSED : seats - 1));
+
+    if (seats == 1)
+        _gameState = STOPPING;
+}
+
+uint8_t Room::getSeats() const
+{
+    const uint8_t seats = _seats;
+    return seats == CLOSED ? 0 : seats;
+}
+
+std::optional<uint8_t> Room::connect(const asio::ip::udp::endpoint &endpoint)
+{
+    for (uint8_t id = 0; id < 4; id++) {
+        if (_playersConnection[id].has_value())
+            continue;
+        *_gameEngine.out << "Room " << _id << ": new connection from " << endpoint << std::endl;
+        _playersConnection[id] = std::make_shared<asio::ip::udp::endpoint>(endpoint);
+        _replication.reset(id);
+        return id;
+    }
+    return std::nullopt;
+}
+
+std::optional<uint8_t> Room::findPlayer(const asio::ip::udp::endpoint &endpoint) const
+{
+    for (uint8_t id = 0; id < 4; id++) {
+        if (_playersConnection[id].has_value() && *_playersConnection[id].value() == endpoint)
+            return id;
+    }
+    return std::nullopt;
+}
+
+void Room::sendRequest(const asio::ip::udp::endpoint &endpoint, const uint8_t requestType, std::vector<uint8_t> payload)
+{
+    // Framed now, so that envelopes are batched like any other message
+    auto framed = _networkingService.frame(endpoint, requestType, std::move(payload));
+    if (framed)
+        _outbox.add(endpoint, framed->messageType, std::move(framed->payload));
+}
+
+void Room::sendRequestResponse(const asio::ip::udp::endpoint &endpoint, const GDTPHeader &header, std::vector<uint8_t> payload)
+{
+    auto framed = _networkingService.frame(endpoint, header.messageType, std::move(payload), header.packetId);
+    if (!framed)
+        return;
+    GDTPHeader response = header;
+    response.messageType = framed->messageType;
+    _sendQueue.push({endpoint, response, framed->messageType, std::move(framed->payload)});
+}
+
+void Room::sendRequestToPlayers(const uint8_t requestType, const std::vector<uint8_t> &payload)
+{
+    for (const auto &playerEntity : _playersConnection) {
+        if (!playerEntity.has_value())
+            continue;
+        sendRequest(
+            *playerEntity.value(),
+            requestType,
+            payload);
+    }
+}
+
+void Room::sendRequestToPlayers(const uint8_t requestType, const std::vector<uint8_t> &payload, const uint8_t selfPlayer)
+{
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!_playersConnection[i].has_value() || i == selfPlayer)
+            continue;
+        sendRequest(
+            *_playersConnection[i].value(),
+            requestType,
+            payload);
+    }
+}
+
+void Room::start()
+{
+    if (_gameState == GAME || _gameState == STOPPING)
+        return;
+
+    *_gameEngine.out << "Room " << _id << ": game starting" << std::endl;
+
+    const core::ecs::Entity world = EntityFactory::createWorld(*this, "assets/JY_map.json");
+    if (const auto spawnPoints = _gameEngine.registry.get_component<World>(world)->spawnPoints; spawnPoints.empty()) {
+        std::cerr << "Error: No spawn points available." << std::endl;
+        return;
+    }
+
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!_playersConnection[i].has_value())
+            continue;
+        _players[i] = EntityFactory::createPlayer(*this, i);
+    }
+
+    _gameEngine.clock.restart();
+    _gameState = GAME;
+}
+
+void Room::update(Server &server)
+{
+    // Commands queued since the last tick run first, in arrival order
+    while (const auto command = _commands.pop())
+        EventFactory::execute(server, *this, *command);
+
+    if (_gameState == GAME) {
+        ++_tick;
+        _gameEngine.registry.run_system<core::ge::TransformComponent, World>();
+        _gameEngine.registry.run_system<Player>();
+        _gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent>();
+        _gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::CollisionComponent>();
+
+        if (_snapshotReplication && ++_ticksSinceSnapshot >= _snapshotInterval) {
+            _ticksSinceSnapshot = 0;
+            replicate();
+        }
+    }
+
+    // One flush per tick: every message of the tick shares as few datagrams as possible
+    _outbox.flush(_sendQueue);
+}
+
+void Room::replicate()
+{
+    // Every client follows the same scrolling view, so they share one area of interest
+    const auto interest = Replication::interestArea(_gameEngine.registry, _interestMargin);
+    const WorldSnapshot snapshot = Replication::capture(_gameEngine.registry, _tick, _gameEngine.delta_t, _correctionThreshold, interest);
+
+    for (uint8_t i = 0; i < 4; i++) {
+        if (!_playersConnection[i].has_value() || !_players[i].has_value())
+            continue;
+        sendRequest(
+            *_playersConnection[i].value(),
+            Snapshot,
+            _replication.encode(i, snapshot, _gameEngine.registry.get_component<Player>(_players[i].value())->inputSequence));
+    }
+}
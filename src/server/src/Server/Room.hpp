@@ -0,0 +1,122 @@
+#ifndef ROOM_HPP
+#define ROOM_HPP
+
+#include <atomic>
+#include <syncstream>
+
+#include "../../../core/ecs/GameEngine/GameEngine.hpp"
+#include "../../../core/network/NetworkService.hpp"
+#include "../../../core/ecs/Entity/Entity.hpp"
+#include "../../../core/config/ConfigManager.hpp"
+#include "../../../game/Movement.hpp"
+#include "Command.hpp"
+#include "MpscQueue.hpp"
+#include "Outbox.hpp"
+#include "Replication.hpp"
+#include "SendQueue.hpp"
+
+class Server;
+
+enum GameState: uint8_t {
+    STARTING,
+    WAITING_CONNECTION,
+    LOBBY,
+    GAME,
+    STOPPING,
+};
+
+// Network ids handed out to the replicated entities of a room, 16-bit in snapshots
+struct NetIds {
+    uint16_t enemy = 0;
+    uint16_t projectile = 0;
+    uint16_t missile = 0;
+};
+
+// One match: its own registry, players and state machine, sharing the server's socket and configuration.
+// A room is pinned to one worker thread, the only one to touch its state: other threads queue commands.
+class Room {
+public:
+    static constexpr size_t COMMAND_QUEUE_SIZE = 1024;
+
+private:
+    static constexpr uint8_t CLOSED = 0xFF;
+
+    uint32_t _id;
+    NetworkingService &_networkingService;
+    SendQueue &_sendQueue;
+    const ConfigManager &_configManager;
+
+    std::osyncstream _log;
+    core::GameEngine _gameEngine;
+
+    std::array<std::optional<std::shared_ptr<asio::ip::udp::endpoint>>, 4> _playersConnection;
+    std::array<std::optional<core::ecs::Entity>, 4> _players;
+
+    std::atomic<GameState> _gameState = WAITING_CONNECTION;
+    // Seats taken or reserved by joining players, CLOSED once the last one left
+    std::atomic<uint8_t> _seats = 0;
+    NetIds _netIds;
+
+    // Simulation ticks since the game started, snapshots carry the one they were captured at
+    uint32_t _tick = 0;
+    // Snapshots are sent every few simulation ticks, clients interpolate between them
+    size_t _snapshotInterval = 1;
+    size_t _ticksSinceSnapshot = 0;
+    bool _snapshotReplication = false;
+    float _interestMargin = 256.0f;
+    float _correctionThreshold = 4.0f;
+    float _inputInterval = 1.0f / movement::DEFAULT_INPUT_RATE;
+    sf::Vector2f _playerSpeed;
+    Replication _replication;
+
+    MpscQueue<Command, COMMAND_QUEUE_SIZE> _commands;
+    Outbox _outbox;
+
+    void replicate();
+
+public:
+    Room(uint32_t id, NetworkingService &networkingService, SendQueue &sendQueue, const ConfigManager &configManager, std::ostream &log, float deltaTime);
+
+    uint32_t getId() const { return _id; }
+    core::GameEngine &getGameEngine() { return _gameEngine; }
+    NetworkingService &getNetworkingService() { return _networkingService; }
+    const ConfigManager &getConfigManager() const { return _configManager; }
+    std::array<std::optional<std::shared_ptr<asio::ip::udp::endpoint>>, 4> &getPlayersConnection() { return _playersConnection; }
+    std::array<std::optional<core::ecs::Entity>, 4> &getPlayers() { return _players; }
+    GameState getGameState() const { return _gameState; }
+    NetIds &getNetIds() { return _netIds; }
+    Replication &getReplication() { return _replication; }
+    bool isSnapshotReplication() const { return _snapshotReplication; }
+    // Every input moves its player for this long, at the player speed
+    float getInputInterval() const { return _inputInterval; }
+    sf::Vector2f getPlayerSpeed() const { return _playerSpeed; }
+
+    void setGameState(const GameState gameState) { _gameState = gameState; }
+
+    // Seat bookkeeping, safe from any thread: a closed room takes no new player and is reaped by the server
+    bool reserveSeat();
+    void releaseSeat();
+    uint8_t getSeats() const;
+    bool isClosed() const { return _seats == CLOSED; }
+
+    // Any thread; false if the queue is full and the command was dropped
+    bool post(const Command &command) { return _commands.push(command); }
+
+    // Takes a free player slot for the endpoint, on the room's worker
+    std::optional<uint8_t> connect(const asio::ip::udp::endpoint &endpoint);
+    // Player slot of a connected endpoint, on the room's worker
+    std::optional<uint8_t> findPlayer(const asio::ip::udp::endpoint &endpoint) const;
+
+    void start();
+    // Runs the queued commands then a simulation step and flushes the messages of the tick, on the room's worker
+    void update(Server &server);
+
+    // Framed for the channel of its type and queued in the outbox until the end of the tick
+    void sendRequest(const asio::ip::udp::endpoint &endpoint, uint8_t requestType, std::vector<uint8_t> payload);
+    // Sent right away, as the client matches the response to its request
+    void sendRequestResponse(const asio::ip::udp::endpoint &endpoint, const GDTPHeader &header, std::vector<uint8_t> payload);
+    void sendRequestToPlayers(uint8_t requestType, const std::vector<uint8_t> &payload);
+    void sendRequestToPlayers(uint8_t requestType, const std::vector<uint8_t> &payload, uint8_t selfPlayer);
+};
+
+#endif //ROOM_HPP
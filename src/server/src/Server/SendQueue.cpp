@@ -0,0 +1,47 @@
+#include "SendQueue.hpp"
+
+SendQueue::SendQueue(NetworkingService &networkingService)
+    : _networkingService(networkingService)
+{
+}
+
+void SendQueue::push(OutboundPacket packet)
+{
+    {
+        std::lock_guard lock(_mutex);
+        _packets.push_back(std::move(packet));
+    }
+    _condition.notify_one();
+}
+
+void SendQueue::start()
+{
+    _thread = std::jthread([this](const std::stop_token &stopToken) { send(stopToken); });
+}
+
+void SendQueue::stop()
+{
+    if (!_thread.joinable())
+        return;
+    _thread.request_stop();
+    _thread.join();
+}
+
+void SendQueue::send(const std::stop_token stopToken)
+{
+    std::vector<OutboundPacket> packets;
+
+    while (true) {
+        {
+            std::unique_lock lock(_mutex);
+            if (!_condition.wait(lock, stopToken, [this] { return !_packets.empty(); }))
+                return;
+            // Take the whole batch so the rooms are never blocked by the socket
+            std::swap(packets, _packets);
+        }
+
+        // One sendmmsg per batch of packets where batched I/O is enabled
+        _networkingService.sendPackets(packets);
+        packets.clear();
+    }
+}
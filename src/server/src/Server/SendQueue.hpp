@@ -0,0 +1,32 @@
+#ifndef SENDQUEUE_HPP
+#define SENDQUEUE_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../../core/network/NetworkService.hpp"
+
+// Packets produced by every room, written to the socket by a single sender thread
+class SendQueue {
+private:
+    NetworkingService &_networkingService;
+
+    std::mutex _mutex;
+    std::condition_variable_any _condition;
+    std::vector<OutboundPacket> _packets;
+    std::jthread _thread;
+
+    void send(std::stop_token stopToken);
+
+public:
+    explicit SendQueue(NetworkingService &networkingService);
+
+    void push(OutboundPacket packet);
+
+    void start();
+    void stop();
+};
+
+#endif //SENDQUEUE_HPP
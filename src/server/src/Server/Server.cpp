@@ -1,140 +1,203 @@
 #include "Server.hpp"
-#include "Components.hpp"
-#include "EntityFactory.hpp"
-#include "Systems.hpp"
 #include "EventFactory.hpp"
+#include "../../../game/Channels.hpp"
 
-bool Server::asPlayerConnected()
+#include <algorithm>
+#include <sstream>
+
+Server::Server()
 {
-    return std::ranges::any_of(_playersConnection, [](const auto &player) { return player.has_value(); });
+    _configManager.parse("assets/Data/config.json");
+    const auto tickRate = std::max(_configManager.getValue<double>("/server/tickRate", 60.0), 1.0);
+    _tickDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+    _maxTicksPerFrame = std::max(_configManager.getValue<size_t>("/server/maxTicksPerFrame", 5), static_cast<size_t>(1));
+    _maxRooms = std::max(_configManager.getValue<size_t>("/server/maxRooms", 16), static_cast<size_t>(1));
+    _networkingService.setBatchedIo(_configManager.getValue<bool>("/server/batchedIo", true));
+    _networkingService.setTransport(_configManager.getValue<std::string>("/server/transport", "asio") == "io_uring"
+        ? NetworkingService::Transport::IoUring : NetworkingService::Transport::Asio);
+    _networkingService.setReceiveThreads(_configManager.getValue<size_t>("/server/receiveThreads", 1));
+
+    size_t workers = _configManager.getValue<size_t>("/server/roomWorkers", 0);
+    if (workers == 0)
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t i = 0; i < workers; i++)
+        _workers.push_back(std::make_unique<Worker>());
+
+    EventFactory::clientMessages(*this);
+    channels::configure(_networkingService);
+
+    _shell.addCommand("stop", "Stop the server", [this](const std::string &) {
+        _running = false;
+        return "Server stopping";
+    });
+    _shell.addCommand("rooms", "List the rooms", [this](const std::string &) {
+        std::lock_guard lock(_roomsMutex);
+        std::ostringstream rooms;
+        rooms << _rooms.size() << " room(s) on " << _workers.size() << " worker(s)";
+        for (const auto &[id, room] : _rooms) {
+            rooms << "\n" << id << ": " << static_cast<int>(room->getSeats()) << " player(s)" << (room->getGameState() == GAME ? ", in game" : ", waiting");
+        }
+        return rooms.str();
+    });
+    _shell.addCommand("kick", "Kick a player", [this](const std::string &args) -> std::string {
+        std::istringstream stream(args);
+        uint32_t roomId = 0;
+        unsigned id = 0;
+        if (!(stream >> roomId >> id) || id >= 4)
+            return "Usage: kick <room_id> <player_id>";
+
+        std::shared_ptr<Room> room;
+        {
+            std::lock_guard lock(_roomsMutex);
+            if (const auto it = _rooms.find(roomId); it != _rooms.end())
+                room = it->second;
+        }
+        if (!room)
+            return "Room not found";
+
+        if (!room->post({.type = CommandType::Kick, .player = static_cast<uint8_t>(id)}))
+            return "Room busy, try again";
+        return "Kick requested";
+    });
 }
 
-void Server::sendRequestToPlayers(const uint8_t requestType, const std::vector<uint8_t> &payload)
+Server::~Server()
 {
-    for (const auto &playerEntity : _playersConnection) {
-        if (!playerEntity.has_value())
-            continue;
-        _networkingService.sendRequest(
-            *playerEntity.value(),
-            requestType,
-            payload);
-    }
+    _shell.close();
 }
 
-void Server::sendRequestToPlayers(const uint8_t requestType, const std::vector<uint8_t> &payload, const uint8_t selfPlayer)
+std::shared_ptr<Room> Server::findRoom(const asio::ip::udp::endpoint &endpoint)
 {
-    for (uint8_t i = 0; i < 4; i++) {
-        if (!_playersConnection[i].has_value() || i == selfPlayer)
-            continue;
-        _networkingService.sendRequest(
-            *_playersConnection[i].value(),
-            requestType,
-            payload);
-    }
+    std::lock_guard lock(_endpointsMutex);
+    const auto it = _endpointRooms.find(endpoint);
+    return it != _endpointRooms.end() ? it->second : nullptr;
 }
 
-Server::Server()
+std::shared_ptr<Room> Server::joinRoom(const asio::ip::udp::endpoint &endpoint)
 {
-    _gameEngine.registry.register_component<Network>();
-    _gameEngine.registry.register_component<World>();
-    _gameEngine.registry.register_component<Player>();
-    _gameEngine.registry.register_component<Enemy>();
-    _gameEngine.registry.register_component<Projectile>();
-
-    _configManager.parse("assets/Data/config.json");
+    std::lock_guard lock(_roomsMutex);
+    if (findRoom(endpoint))
+        return nullptr;
+
+    std::shared_ptr<Room> joined;
+    for (const auto &room : _rooms | std::views::values) {
+        if (room->reserveSeat()) {
+            joined = room;
+            break;
+        }
+    }
 
-    Systems::worldSystem(*this);
+    if (!joined) {
+        if (_rooms.size() >= _maxRooms) {
+            log() << "Server full, refusing " << endpoint << std::endl;
+            return nullptr;
+        }
 
-    EventFactory::gameStarted(*this);
-    EventFactory::playerConnected(*this);
-    EventFactory::playerDisconnected(*this);
-    EventFactory::playerMove(*this);
-    EventFactory::playerProjectileShoot(*this);
-    EventFactory::playerMissileShoot(*this);
+        const uint32_t roomId = _nextRoomId++;
+        joined = std::make_shared<Room>(
+            roomId, _networkingService, _sendQueue, _configManager, _shell.out(), std::chrono::duration<float>(_tickDuration).count());
+        joined->reserveSeat();
+        _rooms.emplace(roomId, joined);
+
+        // Pin the room to the least loaded worker, which runs it until it is closed
+        Worker &worker = **std::ranges::min_element(_workers, {}, [](const auto &candidate) {
+            std::lock_guard workerLock(candidate->mutex);
+            return candidate->rooms.size();
+        });
+        {
+            std::lock_guard workerLock(worker.mutex);
+            worker.rooms.push_back(joined);
+        }
+        log() << "Room " << roomId << " opened" << std::endl;
+    }
 
-    _gameEngine.addCommand("stop", "Stop the server", [this](const std::string &) {
-        _gameState = STOPPING;
-        return "Server stopping";
-    });
-    _gameEngine.addCommand("kick", "Kick a player", [this](const std::string &args) {
-        if (args.empty())
-            return "Usage: kick <player_id>";
-        const uint8_t id = std::stoi(args);
-        if (id >= 4 || !_playersConnection[id].has_value())
-            return "Player not found";
-        _playersConnection[id].reset();
-        _gameEngine.registry.kill_entity(_players[id].value());
-        _players[id].reset();
-        return "Player kicked";
-    });
+    std::lock_guard endpointsLock(_endpointsMutex);
+    _endpointRooms[endpoint] = joined;
+    return joined;
 }
 
-void Server::start()
+void Server::leaveRoom(const asio::ip::udp::endpoint &endpoint)
 {
-    static bool asGameStarted = false;
-    if (asGameStarted)
-        return;
-    asGameStarted = true;
-
-    *_gameEngine.out << "Game starting" << std::endl;
-
-    const core::ecs::Entity world = EntityFactory::createWorld(*this, "assets/JY_map.json");
-    if (const auto spawnPoints = _gameEngine.registry.get_component<World>(world)->spawnPoints; spawnPoints.empty()) {
-        std::cerr << "Error: No spawn points available." << std::endl;
-        return;
-    }
-
-    for (uint8_t i = 0; i < 4; i++) {
-        if (!_playersConnection[i].has_value())
-            continue;
-        _players[i] = EntityFactory::createPlayer(*this, i);
+    {
+        std::lock_guard lock(_endpointsMutex);
+        _endpointRooms.erase(endpoint);
     }
+    _networkingService.forgetPeer(endpoint);
+}
 
-    _gameEngine.clock.restart();
-    _gameState = GAME;
+void Server::removeStoppedRooms()
+{
+    std::lock_guard lock(_roomsMutex);
+    std::erase_if(_rooms, [this](const auto &entry) {
+        const auto &[id, room] = entry;
+        if (!room->isClosed())
+            return false;
+        {
+            std::lock_guard endpointsLock(_endpointsMutex);
+            std::erase_if(_endpointRooms, [&room](const auto &endpointRoom) { return endpointRoom.second == room; });
+        }
+        for (const auto &worker : _workers) {
+            std::lock_guard workerLock(worker->mutex);
+            std::erase(worker->rooms, room);
+        }
+        log() << "Room " << id << " closed" << std::endl;
+        return true;
+    });
 }
 
-void Server::update()
+void Server::runWorker(const std::stop_token &stopToken, Worker &worker)
 {
-    std::lock_guard lock(registry_mutex);
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::shared_ptr<Room>> rooms;
+    Clock::time_point previous = Clock::now();
+    Clock::duration accumulator{};
+
+    while (!stopToken.stop_requested()) {
+        const Clock::time_point now = Clock::now();
+        accumulator += now - previous;
+        previous = now;
+
+        size_t ticks = 0;
+        while (accumulator >= _tickDuration && ticks < _maxTicksPerFrame) {
+            {
+                std::lock_guard lock(worker.mutex);
+                rooms = worker.rooms;
+            }
+            for (const auto &room : rooms)
+                room->update(*this);
+            rooms.clear();
+            accumulator -= _tickDuration;
+            ++ticks;
+        }
+        // Too far behind to catch up: drop the backlog instead of spiralling.
+        if (accumulator >= _tickDuration)
+            accumulator = Clock::duration::zero();
 
-    _gameEngine.registry.run_system<core::ge::TransformComponent, World>();
-    _gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::VelocityComponent>();
-    _gameEngine.registry.run_system<core::ge::TransformComponent, core::ge::CollisionComponent>();
+        std::this_thread::sleep_until(now + (_tickDuration - accumulator));
+    }
 }
 
 void Server::run()
 {
-    sf::Time elapsed;
-
-    while (true) {
-        switch (_gameState) {
-            case STARTING:
-                *_gameEngine.out << "Server started" << std::endl;
-                _networkingService.run();
-                _gameState = WAITING_CONNECTION;
-                continue;
-
-            case WAITING_CONNECTION:
-            case LOBBY:
-                break;
-
-            case GAME:
-                elapsed = _gameEngine.clock.restart();
-                _gameEngine.delta_t = elapsed.asSeconds();
-
-                update();
-                break;
-
-            case STOPPING:
-                *_gameEngine.out << "Server stopped" << std::endl;
-                _networkingService.stop();
-                return;
-        }
-        #ifdef __linux__
-            usleep(1);
-        #elif _WIN32
-            _sleep(1);
-        #endif
+    log() << "Server started with " << _workers.size() << " room worker(s)" << std::endl;
+    _sendQueue.start();
+    _networkingService.run();
+    for (const auto &worker : _workers)
+        worker->thread = std::jthread([this, &worker = *worker](const std::stop_token &stopToken) { runWorker(stopToken, worker); });
+
+    while (_running) {
+        removeStoppedRooms();
+        // Retransmits the reliable messages the clients did not acknowledge
+        _networkingService.update();
+        std::this_thread::sleep_for(_tickDuration);
+    }
+
+    _networkingService.stop();
+    for (const auto &worker : _workers) {
+        worker->thread.request_stop();
+        worker->thread.join();
     }
+    _sendQueue.stop();
+    log() << "Server stopped" << std::endl;
 }
@@ -1,57 +1,69 @@
 #ifndef SERVER_HPP
 #define SERVER_HPP
 
-#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ranges>
+#include <syncstream>
+#include <thread>
 
 #include "../../../core/ecs/GameEngine/GameEngine.hpp"
 #include "../../../core/network/NetworkService.hpp"
-#include "../../../core/ecs/Entity/Entity.hpp"
 #include "../../../core/config/ConfigManager.hpp"
-
-enum GameState: uint8_t {
-    STARTING,
-    WAITING_CONNECTION,
-    LOBBY,
-    GAME,
-    STOPPING,
-};
+#include "Room.hpp"
+#include "SendQueue.hpp"
 
 class Server {
 private:
-    core::GameEngine _gameEngine{false};
+    // Simulation thread and the rooms pinned to it
+    struct Worker {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Room>> rooms;
+        std::jthread thread;
+    };
+
     NetworkingService _networkingService{1111};
     ConfigManager _configManager;
+    core::ge::Shell _shell{core::ecs::Registry{}};
+    SendQueue _sendQueue{_networkingService};
+
+    std::chrono::steady_clock::duration _tickDuration;
+    size_t _maxTicksPerFrame = 5;
+    size_t _maxRooms = 16;
 
-    core::ecs::Entity _world;
-    std::array<std::optional<std::shared_ptr<asio::ip::udp::endpoint>>, 4> _playersConnection;
-    std::array<std::optional<core::ecs::Entity>, 4> _players;
+    std::atomic<bool> _running = true;
 
-    GameState _gameState = STARTING;
+    // Lock order: _roomsMutex, then a worker's mutex or _endpointsMutex
+    std::mutex _roomsMutex;
+    uint32_t _nextRoomId = 0;
+    std::map<uint32_t, std::shared_ptr<Room>> _rooms;
+    std::vector<std::unique_ptr<Worker>> _workers;
 
-    mutable std::shared_mutex registry_mutex;
+    std::mutex _endpointsMutex;
+    std::map<asio::ip::udp::endpoint, std::shared_ptr<Room>> _endpointRooms;
 
-    void update();
+    void runWorker(const std::stop_token &stopToken, Worker &worker);
+    void removeStoppedRooms();
 
 public:
     Server();
+    ~Server();
 
-    core::GameEngine &getGameEngine() { return _gameEngine; }
     NetworkingService &getNetworkingService() { return _networkingService; }
     ConfigManager &getConfigManager() { return _configManager; }
-    std::array<std::optional<std::shared_ptr<asio::ip::udp::endpoint>>, 4> &getPlayersConnection() { return _playersConnection; }
-    std::array<std::optional<core::ecs::Entity>, 4> &getPlayers() { return _players; }
-    std::shared_mutex &getRegistryMutex() const { return registry_mutex; }
-    GameState getGameState() const { return _gameState; }
 
-    void setGameState(const GameState gameState) { _gameState = gameState; }
+    std::osyncstream log() { return std::osyncstream(_shell.out()); }
 
-    void start();
-    void run();
-
-    bool asPlayerConnected();
+    // Room of a connected endpoint, if any
+    std::shared_ptr<Room> findRoom(const asio::ip::udp::endpoint &endpoint);
+    // Seats the endpoint in the first room with a free slot, opening a new room when all are full
+    std::shared_ptr<Room> joinRoom(const asio::ip::udp::endpoint &endpoint);
+    // Forgets the endpoint, and the channels with it
+    void leaveRoom(const asio::ip::udp::endpoint &endpoint);
 
-    void sendRequestToPlayers(uint8_t requestType, const std::vector<uint8_t> &payload);
-    void sendRequestToPlayers(uint8_t requestType, const std::vector<uint8_t> &payload, uint8_t selfPlayer);
+    void run();
 };
 
 #endif //SERVER_HPP
@@ -1,12 +1,12 @@
 #include "Systems.hpp"
 
-#include "Server.hpp"
+#include "Room.hpp"
 #include "Components.hpp"
 #include "EntityFactory.hpp"
 
-void Systems::worldSystem(Server &server)
+void Systems::worldSystem(Room &room)
 {
-    core::GameEngine &gameEngine = server.getGameEngine();
+    core::GameEngine &gameEngine = room.getGameEngine();
 
     gameEngine.registry.add_system<core::ge::TransformComponent, World>(
         [&](const core::ecs::Entity &, const core::ge::TransformComponent &transformComponent,World &world) {
@@ -16,6 +16,17 @@ void Systems::worldSystem(Server &server)
 
             world.lastTimeEnemySpawned = currentTime;
             uint8_t enemyType = rand() % 2;
-            EntityFactory::createEnemy(server, static_cast<uint32_t>(transformComponent.position.x) + world.size.first + 100, enemyType);
+            EntityFactory::createEnemy(room, static_cast<uint32_t>(transformComponent.position.x) + world.size.first + 100, enemyType);
         });
 }
+
+void Systems::playerMovement(Room &room)
+{
+    core::GameEngine &gameEngine = room.getGameEngine();
+
+    // Players move when their inputs are applied: each tick lets them apply inputs for a little longer,
+    // so a client sending faster than the input rate does not move faster
+    gameEngine.registry.add_system<Player>([&](const core::ecs::Entity &, Player &player) {
+        player.inputBudget = std::min(player.inputBudget + gameEngine.delta_t, MAX_INPUT_BURST * room.getInputInterval());
+    });
+}
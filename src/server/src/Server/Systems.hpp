@@ -1,10 +1,14 @@
 #ifndef SYSTEMS_HPP
 #define SYSTEMS_HPP
 
-#include "Server.hpp"
+#include "Room.hpp"
 
 namespace Systems {
-    void worldSystem(Server &server);
+    // Inputs a player may apply at once after a network hiccup
+    constexpr float MAX_INPUT_BURST = 4.0f;
+
+    void worldSystem(Room &room);
+    void playerMovement(Room &room);
 };
 
 #endif //SYSTEMS_HPP